@@ -12,10 +12,26 @@ mkdir -p $BUILD_DIR
 
 # Compiler flags
 CFLAGS="-std=c++17 -fPIC -O2"
+
+# ./build.sh --debug: symbols, and debug-only instrumentation (per-frame heap allocation counter)
+if [ "$1" = "--debug" ]; then
+    CFLAGS="-std=c++17 -fPIC -O1 -g -DF1_DEBUG"
+fi
+# ./build.sh --headless: build/telemetry_headless only - ingest, recording, relay, reference
+# laps and analysis with no GLFW / OpenGL / ImGui, for a display-less Linux box. Needs no
+# thirdparty/ and builds with clang++ or g++ (CXX=g++ ./build.sh --headless)
+if [ "$1" = "--headless" ]; then
+    HEADLESS_SOURCES="core/udpListener.cpp core/udpRelay.cpp core/ioUring.cpp core/asyncLogWriter.cpp core/captureFile.cpp core/sessionReplay.cpp core/packetWriters.cpp core/packetDispatch.cpp core/packetBus.cpp core/latencyHistogram.cpp core/sequenceTracker.cpp live/ReferenceTracker.cpp live/LiveTelemetry.cpp live/TieredHistory.cpp live/CarHistory.cpp live/FrameAssembler.cpp live/LiveSubscribers.cpp live/SessionRegistry.cpp live/FieldState.cpp live/StaticInfo.cpp live/TelemetryAnalysis.cpp live/FramePacer.cpp telemetry/headless.cpp telemetry/main.cpp"
+    echo "Building headless telemetry..."
+    ${CXX:-clang++} $CFLAGS -pthread -DF1_HEADLESS -Icore -Ilive $HEADLESS_SOURCES -o $BUILD_DIR/telemetry_headless
+    echo "Build complete: $BUILD_DIR/telemetry_headless"
+    exit 0
+fi
+
 INCLUDE_DIRS="-Icore -Ilive -I$THIRDPARTY_DIR/imgui -I$THIRDPARTY_DIR/imgui/backends -I$THIRDPARTY_DIR/implot -I$THIRDPARTY_DIR/glfw/include -I$THIRDPARTY_DIR/glad/include -Itools"
 
 # Source files
-SOURCES="core/udpListener.cpp core/packetWriters.cpp live/ReferenceTracker.cpp live/LiveTelemetry.cpp live/Visualizer.cpp live/StaticInfo.cpp telemetry/main.cpp $THIRDPARTY_DIR/imgui/imgui.cpp $THIRDPARTY_DIR/imgui/imgui_demo.cpp $THIRDPARTY_DIR/imgui/imgui_draw.cpp $THIRDPARTY_DIR/imgui/imgui_tables.cpp $THIRDPARTY_DIR/imgui/imgui_widgets.cpp $THIRDPARTY_DIR/imgui/backends/imgui_impl_glfw.cpp $THIRDPARTY_DIR/imgui/backends/imgui_impl_opengl3.cpp $THIRDPARTY_DIR/implot/implot.cpp $THIRDPARTY_DIR/implot/implot_items.cpp $THIRDPARTY_DIR/glad/src/glad.c"
+SOURCES="core/udpListener.cpp core/udpRelay.cpp core/allocationCounter.cpp core/ioUring.cpp core/asyncLogWriter.cpp core/captureFile.cpp core/sessionReplay.cpp core/packetWriters.cpp core/packetDispatch.cpp core/packetBus.cpp core/latencyHistogram.cpp core/sequenceTracker.cpp live/ReferenceTracker.cpp live/LiveTelemetry.cpp live/TieredHistory.cpp live/CarHistory.cpp live/FrameAssembler.cpp live/LiveSubscribers.cpp live/SessionRegistry.cpp live/FieldState.cpp live/TelemetryAnalysis.cpp live/FramePacer.cpp live/PlotLod.cpp live/Visualizer.cpp live/StaticInfo.cpp telemetry/headless.cpp telemetry/main.cpp $THIRDPARTY_DIR/imgui/imgui.cpp $THIRDPARTY_DIR/imgui/imgui_demo.cpp $THIRDPARTY_DIR/imgui/imgui_draw.cpp $THIRDPARTY_DIR/imgui/imgui_tables.cpp $THIRDPARTY_DIR/imgui/imgui_widgets.cpp $THIRDPARTY_DIR/imgui/backends/imgui_impl_glfw.cpp $THIRDPARTY_DIR/imgui/backends/imgui_impl_opengl3.cpp $THIRDPARTY_DIR/implot/implot.cpp $THIRDPARTY_DIR/implot/implot_items.cpp $THIRDPARTY_DIR/glad/src/glad.c"
 
 # Link libraries (macOS)
 LIBS="-framework CoreFoundation -framework Cocoa -framework IOKit -framework OpenGL -framework Metal -framework MetalKit -framework QuartzCore"
@@ -28,7 +44,25 @@ clang++ $CFLAGS $INCLUDE_DIRS $SOURCES $GLFW_LIB $LIBS -o $BUILD_DIR/telemetry_v
 echo "Build complete: $BUILD_DIR/telemetry_viz"
 
 # Build the calibration tool
-CALIB_SOURCES="tools/track_calibration/track_calibration.cpp live/StaticInfo.cpp live/ReferenceTracker.cpp live/LiveTelemetry.cpp"
+CALIB_SOURCES="tools/track_calibration/track_calibration.cpp live/StaticInfo.cpp live/ReferenceTracker.cpp live/LiveTelemetry.cpp live/TieredHistory.cpp live/CarHistory.cpp live/FrameAssembler.cpp core/latencyHistogram.cpp"
 clang++ $CFLAGS $INCLUDE_DIRS $CALIB_SOURCES -o $BUILD_DIR/track_calibration
 
-echo "Build complete: $BUILD_DIR/track_calibration"
\ No newline at end of file
+echo "Build complete: $BUILD_DIR/track_calibration"
+
+# Build the capture render tool
+RENDER_SOURCES="tools/render_capture/render_capture.cpp core/captureFile.cpp core/ioUring.cpp core/packetWriters.cpp core/packetDispatch.cpp"
+clang++ $CFLAGS $INCLUDE_DIRS $RENDER_SOURCES -o $BUILD_DIR/render_capture
+
+echo "Build complete: $BUILD_DIR/render_capture"
+
+# Build the synthetic packet generator / load-test harness
+GEN_SOURCES="tools/packet_generator/packet_generator.cpp core/udpListener.cpp core/udpRelay.cpp core/ioUring.cpp core/asyncLogWriter.cpp core/captureFile.cpp core/packetWriters.cpp core/packetDispatch.cpp core/packetBus.cpp core/latencyHistogram.cpp core/sequenceTracker.cpp live/LiveTelemetry.cpp live/TieredHistory.cpp live/CarHistory.cpp live/FrameAssembler.cpp live/LiveSubscribers.cpp live/SessionRegistry.cpp live/FieldState.cpp live/StaticInfo.cpp live/ReferenceTracker.cpp"
+clang++ $CFLAGS $INCLUDE_DIRS $GEN_SOURCES -o $BUILD_DIR/packet_generator
+
+echo "Build complete: $BUILD_DIR/packet_generator"
+
+# Build the live ring buffer stress test
+STRESS_SOURCES="tools/ringbuffer_stress/ringbuffer_stress.cpp"
+clang++ $CFLAGS $INCLUDE_DIRS $STRESS_SOURCES -o $BUILD_DIR/ringbuffer_stress
+
+echo "Build complete: $BUILD_DIR/ringbuffer_stress"
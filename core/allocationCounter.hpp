@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+
+// Heap allocations (global operator new) made by the calling thread so far. Only debug
+// builds count them (./build.sh --debug defines F1_DEBUG, which replaces operator new);
+// elsewhere this is always 0. ImGui / ImPlot allocate through malloc and aren't counted.
+uint64_t threadAllocations();
+
+#ifdef F1_DEBUG
+constexpr bool kCountingAllocations = true;
+#else
+constexpr bool kCountingAllocations = false;
+#endif
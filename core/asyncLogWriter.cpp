@@ -0,0 +1,233 @@
+#include "asyncLogWriter.hpp"
+#include "packetStructs.hpp"
+#include "packetWriters.hpp"
+#include "ioUring.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <sys/stat.h>
+#include <map>
+#include <set>
+#include <memory>
+#include <string>
+
+AsyncLogWriter g_packetLog;
+
+static std::string logDirectory = "telemetry_data";
+
+// What the writer thread keeps open for one session - only touched by the writer thread
+struct SessionRecorder {
+    std::unique_ptr<CaptureWriter> capture;
+    std::map<uint8_t, std::shared_ptr<std::ofstream>> textFiles;   // per packet type
+    uint64_t lastPacketNs = 0;   // wall clock receive time, for closing idle recorders
+};
+
+static std::map<SessionKey, SessionRecorder> recorders;
+static std::set<std::pair<SessionKey, uint8_t>> textLogsStarted;   // truncated once per run, appended after
+
+static void ensureDirectory(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        mkdir(path.c_str(), 0755);
+    }
+}
+
+// Helper function to get or create cached file handle. Text logs of a session go in
+// their own directory, <source>_<sessionUID>/, started fresh for each run and appended to
+// if the session's files were closed while it was idle.
+static std::ofstream& getCachedFileHandle(SessionRecorder& recorder, const SessionKey& key, uint8_t packetId) {
+    auto it = recorder.textFiles.find(packetId);
+    if (it == recorder.textFiles.end()) {
+        std::stringstream directory;
+        directory << logDirectory << "/" << sessionSourceName(key) << "_" << std::hex << key.sessionUID;
+        ensureDirectory(logDirectory);
+        ensureDirectory(directory.str());
+
+        std::string filename = directory.str() + "/" + getPacketTypeName(packetId) + ".txt";
+        bool fresh = textLogsStarted.insert({key, packetId}).second;
+        auto filePtr = std::make_shared<std::ofstream>(filename, fresh ? std::ios::trunc : std::ios::app);
+        if (!filePtr->is_open()) {
+            std::cerr << "Warning: Unable to open file: " << filename << "\n";
+        }
+        it = recorder.textFiles.emplace(packetId, filePtr).first;
+    }
+
+    return *it->second;
+}
+
+static void flushRecorder(SessionRecorder& recorder) {
+    if (recorder.capture) recorder.capture->flush();
+    for (auto& entry : recorder.textFiles) {
+        entry.second->flush();
+    }
+}
+
+static void flushAllFiles() {
+    for (auto& entry : recorders) {
+        flushRecorder(entry.second);
+    }
+}
+
+// Close the files of sessions that have sent nothing for idleNs
+static void closeIdleRecorders(uint64_t nowWallNs, uint64_t idleNs) {
+    for (auto it = recorders.begin(); it != recorders.end();) {
+        if (nowWallNs > it->second.lastPacketNs && nowWallNs - it->second.lastPacketNs > idleNs) {
+            if (it->second.capture) it->second.capture->close();
+            it = recorders.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Helper function to write packet to file
+static void writePacketToFile(SessionRecorder& recorder, const SessionKey& key, const PacketSlot& slot) {
+    // localtime() + strftime are only re-run when the receive second changes
+    static time_t cachedSecond = -1;
+    static char cachedStamp[32] = {0};
+
+    try {
+        const PacketHeader* header = reinterpret_cast<const PacketHeader*>(slot.data);
+        std::ofstream& file = getCachedFileHandle(recorder, key, header->m_packetId);
+        if (!file.is_open()) {
+            return;
+        }
+
+        // timestamp
+        time_t t = static_cast<time_t>(slot.received.wallNs / 1000000000ull);
+        if (t != cachedSecond) {
+            cachedSecond = t;
+            std::strftime(cachedStamp, sizeof(cachedStamp), "%Y-%m-%d %H:%M:%S", std::localtime(&t));
+        }
+        file << "==== " << cachedStamp << " ====\n";
+
+        callPacketTypeWriter(slot.data, file, header->m_packetId);
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error writing packet file: " << e.what() << "\n";
+    }
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+    stop();
+}
+
+void AsyncLogWriter::start(const AsyncLogConfig& config) {
+    if (running()) return;
+
+    config_ = config;
+    queue_.reset(new PacketQueue(config_.queueCapacity));
+    logDirectory = config_.directory;
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&AsyncLogWriter::run, this);
+}
+
+void AsyncLogWriter::stop() {
+    if (!running()) return;
+
+    running_.store(false, std::memory_order_release);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool AsyncLogWriter::submit(const uint8_t* data, size_t size, const ReceiveInfo& received) {
+    if (!running()) return false;
+
+    std::lock_guard<std::mutex> lock(submitMutex_);
+    if (!queue_->tryPush(data, size, received)) {
+        stats_.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    stats_.submitted.fetch_add(1, std::memory_order_relaxed);
+
+    size_t depth = queue_->size();
+    if (depth > stats_.highWater.load(std::memory_order_relaxed)) {
+        stats_.highWater.store(depth, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void AsyncLogWriter::attach(PacketBus& bus) {
+    bus.subscribeRaw("packet_log", kAllPackets,
+                     [this](const uint8_t* data, size_t size, const ReceiveInfo& received) {
+                         submit(data, size, received);
+                     });
+}
+
+void AsyncLogWriter::run() {
+    using clock = std::chrono::steady_clock;
+    const auto flushInterval = std::chrono::milliseconds(config_.flushIntervalMs);
+    const uint64_t idleNs = static_cast<uint64_t>(config_.sessionIdleSeconds * 1e9);
+    auto lastFlush = clock::now();
+    uint64_t newestWallNs = 0;
+    bool dirty = false;
+
+    // All sessions' captures share one ring: a flush is one io_uring_enter for every file
+    IoUring ring;
+    IoUring* captureRing = nullptr;
+    if (config_.capture && config_.ioUring) {
+        if (ring.init(256)) {
+            captureRing = &ring;
+        } else {
+            std::cerr << "Packet log: io_uring unavailable, writing captures through ofstream\n";
+        }
+    }
+    auto submitCaptureWrites = [&]() {
+        if (!captureRing || captureRing->queued() == 0) return;
+        captureRing->submit();
+        stats_.ringSubmits.fetch_add(1, std::memory_order_relaxed);
+        CaptureWriter::completeWrites(*captureRing);
+    };
+
+    // Keep draining after stop() so nothing already queued is lost
+    while (running() || queue_->front() != nullptr) {
+        const PacketSlot* slot = queue_->front();
+        if (slot) {
+            // Each session gets its own capture file and text logs
+            const SessionKey key = SessionKey::of(*reinterpret_cast<const PacketHeader*>(slot->data), slot->received);
+            SessionRecorder& recorder = recorders[key];
+            recorder.lastPacketNs = newestWallNs = slot->received.wallNs;
+            if (config_.capture) {
+                if (!recorder.capture) {
+                    recorder.capture.reset(new CaptureWriter(config_.directory,
+                                                             key.sourceAddress ? sessionSourceName(key) : "",
+                                                             captureRing));
+                }
+                uint64_t before = recorder.capture->bytesWritten();
+                recorder.capture->append(slot->data, slot->size, slot->received.wallNs);
+                stats_.captureBytes.fetch_add(recorder.capture->bytesWritten() - before, std::memory_order_relaxed);
+            }
+            if (config_.textLogs) {
+                writePacketToFile(recorder, key, *slot);
+            }
+            queue_->pop();
+            stats_.written.fetch_add(1, std::memory_order_relaxed);
+            dirty = true;
+        } else {
+            if (captureRing) CaptureWriter::completeWrites(*captureRing);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        auto now = clock::now();
+        if (dirty && now - lastFlush >= flushInterval) {
+            flushAllFiles();
+            submitCaptureWrites();
+            closeIdleRecorders(newestWallNs, idleNs);
+            stats_.flushes.fetch_add(1, std::memory_order_relaxed);
+            stats_.sessions.store(recorders.size(), std::memory_order_relaxed);
+            lastFlush = now;
+            dirty = false;
+        }
+    }
+
+    for (auto& entry : recorders) {
+        if (entry.second.capture) entry.second.capture->close();
+    }
+    flushAllFiles();
+    recorders.clear();
+}
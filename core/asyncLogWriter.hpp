@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "packetQueue.hpp"
+#include "captureFile.hpp"
+#include "packetBus.hpp"
+#include "sessionKey.hpp"
+
+struct AsyncLogConfig {
+    size_t queueCapacity = 4096;   // packets buffered between the listener and the writer thread
+    int flushIntervalMs = 500;     // how often the writer thread flushes its open files
+    bool capture = true;           // append raw datagrams to a binary .f1cap session capture
+    bool textLogs = false;         // also format every packet into telemetry_data/<source>_<uid>/*.txt
+    std::string directory = "telemetry_data";
+    double sessionIdleSeconds = 600;   // close a session's files once it has sent nothing for this long
+    bool ioUring = false;          // Linux 6.0+: capture writes go through one io_uring, ofstream otherwise
+};
+
+// Writer-side counters, readable from any thread
+struct AsyncLogStats {
+    std::atomic<uint64_t> submitted{0};   // packets accepted into the queue
+    std::atomic<uint64_t> dropped{0};     // packets rejected because the queue was full
+    std::atomic<uint64_t> written{0};     // packets handed to the capture / text writers
+    std::atomic<uint64_t> captureBytes{0}; // bytes appended to the binary capture
+    std::atomic<uint64_t> flushes{0};     // batched flushes performed
+    std::atomic<uint64_t> highWater{0};   // deepest queue occupancy seen
+    std::atomic<uint64_t> sessions{0};    // sessions with files open, as of the last flush
+    std::atomic<uint64_t> ringSubmits{0}; // io_uring_enter calls that carried capture writes
+};
+
+// Records packets (binary capture and/or per-type text logs) on its own thread, so a slow
+// disk never stalls the receive loop. Every (source IP, session UID) gets its own capture
+// file and text logs. submit() may be called from several listener threads; they take
+// turns on the queue's single producer slot.
+class AsyncLogWriter {
+public:
+    AsyncLogWriter() = default;
+    ~AsyncLogWriter();
+
+    AsyncLogWriter(const AsyncLogWriter&) = delete;
+    AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+    void start(const AsyncLogConfig& config = AsyncLogConfig{});
+    void stop();   // drains the queue, flushes and joins the writer thread
+
+    // Copy a raw packet into the queue; returns false (and counts a drop) when full
+    bool submit(const uint8_t* data, size_t size, const ReceiveInfo& received);
+
+    // Record every packet type published on `bus`. Runs inline: submit() only copies
+    // into this writer's own queue, so the disk work stays on the writer thread.
+    void attach(PacketBus& bus);
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+    const AsyncLogStats& stats() const { return stats_; }
+
+private:
+    void run();
+
+    AsyncLogConfig config_;
+    std::unique_ptr<PacketQueue> queue_;
+    std::mutex submitMutex_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    AsyncLogStats stats_;
+};
+
+extern AsyncLogWriter g_packetLog;
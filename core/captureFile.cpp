@@ -0,0 +1,291 @@
+#include "captureFile.hpp"
+#include "packetStructs.hpp"
+#include "ioUring.hpp"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <ctime>
+#include <utility>
+#include <memory>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// ===================== WRITER =====================
+
+// Staged records are queued once this much has built up, not only at flush()
+static constexpr size_t kStageLimit = 1 << 20;
+static constexpr size_t kWriteChunk = 256 * 1024;
+
+// One queued write; its address is the request's user data
+struct CaptureWrite {
+    CaptureWriter* owner;
+    std::shared_ptr<std::vector<uint8_t>> buffer;   // shared by the chunks of one flush
+    size_t start;
+    uint32_t size;
+    uint64_t offset;
+    int fd;
+};
+
+// Synchronous tail of a write the ring didn't finish: short, failed, or cancelled because
+// an earlier write in its chain failed
+static bool writeRemainder(int fd, const uint8_t* data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+CaptureWriter::CaptureWriter(std::string directory, std::string label, IoUring* ring)
+    : directory_(std::move(directory)), label_(std::move(label)), ring_(ring) {}
+
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+bool CaptureWriter::open(uint64_t sessionUID, uint64_t receivedNs) {
+    close();
+
+    struct stat st;
+    if (stat(directory_.c_str(), &st) != 0) {
+        mkdir(directory_.c_str(), 0755);
+    }
+
+    time_t t = static_cast<time_t>(receivedNs / 1000000000ull);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&t));
+
+    std::stringstream filename;
+    filename << directory_ << "/session_" << std::hex << std::setw(16) << std::setfill('0') << sessionUID
+             << std::dec << (label_.empty() ? "" : "_" + label_) << "_" << stamp << ".f1cap";
+    path_ = filename.str();
+
+    if (ring_) {
+        fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        fileOffset_ = 0;
+    } else {
+        file_.open(path_, std::ios::binary | std::ios::trunc);
+    }
+    if (!isOpen()) {
+        std::cerr << "Warning: Unable to open capture file: " << path_ << "\n";
+        return false;
+    }
+
+    CaptureFileHeader header{};
+    std::memcpy(header.magic, kCaptureMagic, sizeof(header.magic));
+    header.version = kCaptureVersion;
+    header.packetFormat = 2023;
+    header.sessionUID = sessionUID;
+    header.createdNs = receivedNs;
+    put(&header, sizeof(header));
+
+    sessionUID_ = sessionUID;
+    datagrams_ = 0;
+    bytesWritten_ += sizeof(header);
+    std::cout << "Recording session " << std::hex << sessionUID << std::dec << " to " << path_ << "\n";
+    return true;
+}
+
+void CaptureWriter::writeSync(uint64_t receivedNs) {
+    CaptureRecordHeader record{};
+    record.length = sizeof(kCaptureSyncMagic) + sizeof(uint64_t);
+    record.kind = CAPTURE_SYNC;
+    record.receivedNs = receivedNs;
+
+    put(&record, sizeof(record));
+    put(kCaptureSyncMagic, sizeof(kCaptureSyncMagic));
+    put(&datagrams_, sizeof(datagrams_));
+    bytesWritten_ += sizeof(record) + record.length;
+}
+
+bool CaptureWriter::isOpen() const {
+    return ring_ ? fd_ >= 0 : file_.is_open();
+}
+
+void CaptureWriter::put(const void* data, size_t size) {
+    if (!ring_) {
+        file_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        return;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    staged_.insert(staged_.end(), bytes, bytes + size);
+    if (staged_.size() >= kStageLimit) queueStaged();
+}
+
+// Hands the staged records to the ring as one chain of writes
+void CaptureWriter::queueStaged() {
+    if (staged_.empty() || fd_ < 0) return;
+
+    std::shared_ptr<std::vector<uint8_t>> buffer = std::make_shared<std::vector<uint8_t>>();
+    buffer->swap(staged_);
+    staged_.reserve(buffer->capacity());
+
+    for (size_t start = 0; start < buffer->size(); start += kWriteChunk) {
+        uint32_t size = static_cast<uint32_t>(std::min(kWriteChunk, buffer->size() - start));
+        bool last = start + size == buffer->size();
+        CaptureWrite* write = new CaptureWrite{this, buffer, start, size, fileOffset_ + start, fd_};
+        uint64_t userData = reinterpret_cast<uint64_t>(write);
+        if (!ring_->queueWrite(fd_, buffer->data() + start, size, write->offset, userData, !last)) {
+            // Submission ring full: send what is queued and try again
+            ring_->submit();
+            if (!ring_->queueWrite(fd_, buffer->data() + start, size, write->offset, userData, !last)) {
+                writeRemainder(fd_, buffer->data() + start, size, write->offset);
+                delete write;
+                continue;
+            }
+        }
+        ++inFlight_;
+    }
+    fileOffset_ += buffer->size();
+}
+
+void CaptureWriter::completeWrites(IoUring& ring) {
+    UringCompletion done[64];
+    size_t n;
+    while ((n = ring.reap(done, 64)) > 0) {
+        for (size_t i = 0; i < n; ++i) {
+            CaptureWrite* write = reinterpret_cast<CaptureWrite*>(done[i].userData);
+            size_t written = done[i].result > 0 ? static_cast<size_t>(done[i].result) : 0;
+            if (written < write->size &&
+                !writeRemainder(write->fd, write->buffer->data() + write->start + written,
+                                write->size - written, write->offset + written)) {
+                std::cerr << "Warning: capture write failed: " << write->owner->path_ << "\n";
+            }
+            --write->owner->inFlight_;
+            delete write;
+        }
+    }
+}
+
+bool CaptureWriter::append(const uint8_t* data, size_t size, uint64_t receivedNs) {
+    if (size < sizeof(PacketHeader) || size > kCaptureMaxPayload) {
+        return false;
+    }
+
+    const PacketHeader* packetHeader = reinterpret_cast<const PacketHeader*>(data);
+    if (!isOpen() || packetHeader->m_sessionUID != sessionUID_) {
+        if (!open(packetHeader->m_sessionUID, receivedNs)) {
+            return false;
+        }
+    }
+
+    if (datagrams_ % kCaptureSyncInterval == 0) {
+        writeSync(receivedNs);
+    }
+
+    CaptureRecordHeader record{};
+    record.length = static_cast<uint16_t>(size);
+    record.kind = CAPTURE_DATAGRAM;
+    record.receivedNs = receivedNs;
+
+    put(&record, sizeof(record));
+    put(data, size);
+    ++datagrams_;
+    bytesWritten_ += sizeof(record) + size;
+    return true;
+}
+
+void CaptureWriter::flush() {
+    if (ring_) {
+        queueStaged();
+    } else if (file_.is_open()) {
+        file_.flush();
+    }
+}
+
+void CaptureWriter::close() {
+    if (ring_) {
+        // Everything queued must land before the descriptor goes
+        queueStaged();
+        while (inFlight_ > 0) {
+            if (!ring_->submit(1)) break;
+            completeWrites(*ring_);
+        }
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    } else if (file_.is_open()) {
+        file_.close();
+    }
+}
+
+// ===================== READER =====================
+
+bool CaptureReader::open(const std::string& path) {
+    file_.open(path, std::ios::binary);
+    if (!file_) {
+        std::cerr << "Failed to open " << path << " for reading\n";
+        return false;
+    }
+
+    file_.read(reinterpret_cast<char*>(&header_), sizeof(header_));
+    if (!file_ || std::memcmp(header_.magic, kCaptureMagic, sizeof(kCaptureMagic)) != 0) {
+        std::cerr << path << " is not an F1 capture file\n";
+        return false;
+    }
+    if (header_.version != kCaptureVersion || header_.packetFormat != 2023) {
+        std::cerr << path << ": unsupported capture version " << header_.version
+                  << " / packet format " << header_.packetFormat << "\n";
+        return false;
+    }
+    return true;
+}
+
+void CaptureReader::rewind() {
+    file_.clear();
+    file_.seekg(sizeof(CaptureFileHeader), std::ios::beg);
+}
+
+// Scan forward for the next sync marker and position the stream just after it
+bool CaptureReader::resync() {
+    ++resyncs_;
+    size_t matched = 0;
+    char c;
+    while (file_.get(c)) {
+        if (c == kCaptureSyncMagic[matched]) {
+            if (++matched == sizeof(kCaptureSyncMagic)) {
+                uint64_t count;
+                return static_cast<bool>(file_.read(reinterpret_cast<char*>(&count), sizeof(count)));
+            }
+        } else {
+            matched = (c == kCaptureSyncMagic[0]) ? 1 : 0;
+        }
+    }
+    return false;
+}
+
+bool CaptureReader::next(CaptureRecord& out) {
+    CaptureRecordHeader record;
+    while (file_.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (record.kind == CAPTURE_SYNC && record.length == sizeof(kCaptureSyncMagic) + sizeof(uint64_t)) {
+            char magic[sizeof(kCaptureSyncMagic)];
+            uint64_t count;
+            file_.read(magic, sizeof(magic));
+            file_.read(reinterpret_cast<char*>(&count), sizeof(count));
+            if (file_ && std::memcmp(magic, kCaptureSyncMagic, sizeof(magic)) == 0) {
+                continue;
+            }
+        } else if (record.kind == CAPTURE_DATAGRAM && record.length >= sizeof(PacketHeader)
+                   && record.length <= kCaptureMaxPayload) {
+            if (!file_.read(reinterpret_cast<char*>(out.data), record.length)) {
+                return false;   // truncated tail (recording was cut off mid-write)
+            }
+            const PacketHeader* header = reinterpret_cast<const PacketHeader*>(out.data);
+            if (header->m_packetFormat == 2023) {
+                out.receivedNs = record.receivedNs;
+                out.size = record.length;
+                return true;
+            }
+        }
+
+        if (!file_ || !resync()) {
+            return false;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class IoUring;
+
+// ===================== CAPTURE FORMAT =====================
+//
+// Append-only binary recording of raw F1 datagrams (*.f1cap):
+//
+//   CaptureFileHeader
+//   { CaptureRecordHeader, payload[length] } ...
+//
+// Datagram records carry the packet bytes exactly as received. Every kCaptureSyncInterval
+// datagrams a sync record is written whose payload is kCaptureSyncMagic followed by the
+// running datagram count, so a reader can resynchronise after a torn or corrupted write.
+// All integers are little-endian (native on every platform we build for).
+
+#pragma pack(push, 1)
+
+struct CaptureFileHeader {
+    char     magic[8];        // "F1PWCAP\0"
+    uint16_t version;         // kCaptureVersion
+    uint16_t packetFormat;    // 2023
+    uint32_t reserved;
+    uint64_t sessionUID;      // m_sessionUID of the first packet in the file
+    uint64_t createdNs;       // system_clock time the file was opened
+};
+
+enum CaptureRecordKind : uint8_t {
+    CAPTURE_DATAGRAM = 0,
+    CAPTURE_SYNC = 1
+};
+
+struct CaptureRecordHeader {
+    uint16_t length;          // payload bytes following this header
+    uint8_t  kind;            // CaptureRecordKind
+    uint8_t  reserved;
+    uint64_t receivedNs;      // system_clock receive time
+};
+
+#pragma pack(pop)
+
+constexpr char kCaptureMagic[8] = {'F', '1', 'P', 'W', 'C', 'A', 'P', '\0'};
+constexpr char kCaptureSyncMagic[8] = {'F', '1', 'P', 'W', 'S', 'Y', 'N', 'C'};
+constexpr uint16_t kCaptureVersion = 1;
+constexpr uint32_t kCaptureSyncInterval = 1024;
+constexpr size_t kCaptureMaxPayload = 2048;
+
+// Appends datagrams to one capture file per session. Not thread-safe; owned by one thread.
+// A non-empty label (the sender, when several rigs are recorded) goes into the file name.
+//
+// Given an IoUring, records are staged in memory and flush() queues them on the ring as
+// linked writes at explicit file offsets; the ring's owner submits them and calls
+// completeWrites(). Without one they go through an ofstream.
+class CaptureWriter {
+public:
+    explicit CaptureWriter(std::string directory = "telemetry_data", std::string label = "",
+                           IoUring* ring = nullptr);
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    // Opens (or rolls over to) a file for the datagram's m_sessionUID on demand
+    bool append(const uint8_t* data, size_t size, uint64_t receivedNs);
+    void flush();
+    void close();
+
+    const std::string& path() const { return path_; }
+    uint64_t bytesWritten() const { return bytesWritten_; }
+
+    // Finish the writes that completed on `ring`, for every writer queued on it
+    static void completeWrites(IoUring& ring);
+
+private:
+    bool open(uint64_t sessionUID, uint64_t receivedNs);
+    bool isOpen() const;
+    void writeSync(uint64_t receivedNs);
+    void put(const void* data, size_t size);
+    void queueStaged();
+
+    std::string directory_;
+    std::string label_;
+    std::string path_;
+    std::ofstream file_;
+
+    IoUring* ring_;
+    int fd_ = -1;
+    std::vector<uint8_t> staged_;   // records not yet queued on the ring
+    uint64_t fileOffset_ = 0;       // where the next queued write goes
+    unsigned inFlight_ = 0;         // writes queued and not completed
+    uint64_t sessionUID_ = 0;
+    uint64_t datagrams_ = 0;
+    uint64_t bytesWritten_ = 0;
+};
+
+struct CaptureRecord {
+    uint64_t receivedNs;
+    uint16_t size;
+    uint8_t data[kCaptureMaxPayload];
+};
+
+// Sequential reader over a capture file; skips sync records and resynchronises on corruption
+class CaptureReader {
+public:
+    bool open(const std::string& path);
+    bool next(CaptureRecord& out);   // false at end of file
+    void rewind();
+
+    const CaptureFileHeader& header() const { return header_; }
+    uint64_t resyncs() const { return resyncs_; }
+
+private:
+    bool resync();
+
+    std::ifstream file_;
+    CaptureFileHeader header_{};
+    uint64_t resyncs_ = 0;
+};
@@ -0,0 +1,248 @@
+#include "ioUring.hpp"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// The rings are shared with the kernel: our side publishes with release stores and picks
+// up the kernel's indices with acquire loads
+static unsigned loadAcquire(const unsigned* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static void storeRelease(unsigned* p, unsigned v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+static void* mapRing(int fd, size_t size, uint64_t offset) {
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    return p == MAP_FAILED ? nullptr : p;
+}
+
+IoUring::~IoUring() {
+    teardown();
+}
+
+void IoUring::teardown() {
+    if (bufRing_) munmap(bufRing_, bufRingSize_);
+    if (sqes_) munmap(sqes_, sqesSize_);
+    if (cqRing_ && cqRing_ != sqRing_) munmap(cqRing_, cqRingSize_);
+    if (sqRing_) munmap(sqRing_, sqRingSize_);
+    if (fd_ >= 0) close(fd_);
+    bufRing_ = sqes_ = cqRing_ = sqRing_ = nullptr;
+    fd_ = -1;
+}
+
+bool IoUring::init(unsigned entries) {
+    // Only this thread submits, and completions are run when it next enters the kernel
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN;
+    int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) return false;   // ENOSYS, EPERM (disabled) or EINVAL (pre-6.0 flags)
+
+    const unsigned required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if ((params.features & required) != required) {
+        close(fd);
+        return false;
+    }
+    fd_ = fd;
+    features_ = params.features;
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (cqRingSize_ > sqRingSize_) sqRingSize_ = cqRingSize_;
+    sqRing_ = mapRing(fd_, sqRingSize_, IORING_OFF_SQ_RING);
+    cqRing_ = sqRing_;   // IORING_FEAT_SINGLE_MMAP: one mapping holds both rings
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = mapRing(fd_, sqesSize_, IORING_OFF_SQES);
+    if (!sqRing_ || !sqes_) {
+        teardown();
+        return false;
+    }
+
+    uint8_t* sq = static_cast<uint8_t*>(sqRing_);
+    sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqKernelTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqEntries_ = params.sq_entries;
+    sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    for (unsigned i = 0; i < sqEntries_; ++i) sqArray_[i] = i;
+    sqTail_ = submitted_ = *sqKernelTail_;
+
+    uint8_t* cq = static_cast<uint8_t*>(cqRing_);
+    cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = cq + params.cq_off.cqes;
+    return true;
+}
+
+// Next free submission entry, zeroed, or nullptr while the ring is full
+static io_uring_sqe* takeSqe(void* sqes, unsigned& tail, unsigned mask, unsigned entries, const unsigned* head) {
+    if (tail - loadAcquire(head) >= entries) return nullptr;
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes) + (tail & mask);
+    std::memset(sqe, 0, sizeof(*sqe));
+    ++tail;
+    return sqe;
+}
+
+bool IoUring::queueRecvMsgMultishot(int sock, const msghdr* layout, uint16_t bufferGroup, uint64_t userData) {
+    io_uring_sqe* sqe = takeSqe(sqes_, sqTail_, sqMask_, sqEntries_, sqHead_);
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = sock;
+    sqe->addr = reinterpret_cast<uint64_t>(layout);
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = bufferGroup;
+    sqe->user_data = userData;
+    return true;
+}
+
+bool IoUring::queueWrite(int fd, const void* data, uint32_t size, uint64_t offset, uint64_t userData, bool linkNext) {
+    io_uring_sqe* sqe = takeSqe(sqes_, sqTail_, sqMask_, sqEntries_, sqHead_);
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = size;
+    sqe->off = offset;
+    sqe->flags = linkNext ? IOSQE_IO_LINK : 0;
+    sqe->user_data = userData;
+    return true;
+}
+
+bool IoUring::submit(unsigned waitFor, int timeoutMs) {
+    unsigned toSubmit = sqTail_ - submitted_;
+    if (toSubmit == 0 && waitFor == 0) return true;
+    storeRelease(sqKernelTail_, sqTail_);
+
+    unsigned flags = waitFor ? IORING_ENTER_GETEVENTS : 0;
+    __kernel_timespec timeout = {};
+    io_uring_getevents_arg arg = {};
+    const void* argp = nullptr;
+    size_t argSize = 0;
+    if (waitFor && timeoutMs >= 0) {
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = (timeoutMs % 1000) * 1000000ll;
+        arg.ts = reinterpret_cast<uint64_t>(&timeout);
+        flags |= IORING_ENTER_EXT_ARG;
+        argp = &arg;
+        argSize = sizeof(arg);
+    }
+
+    long ret = syscall(__NR_io_uring_enter, fd_, toSubmit, waitFor, flags, argp, argSize);
+    submitted_ = loadAcquire(sqHead_);   // whatever the kernel consumed, even if the wait failed
+    if (ret >= 0) return true;
+    return errno == ETIME || errno == EINTR || errno == EAGAIN || errno == EBUSY;
+}
+
+size_t IoUring::reap(UringCompletion* out, size_t maxCount) {
+    unsigned head = *cqHead_;
+    const unsigned tail = loadAcquire(cqTail_);
+    size_t n = 0;
+    const io_uring_cqe* cqes = static_cast<const io_uring_cqe*>(cqes_);
+    while (head != tail && n < maxCount) {
+        const io_uring_cqe& cqe = cqes[head & cqMask_];
+        out[n++] = {cqe.user_data, cqe.res, cqe.flags};
+        ++head;
+    }
+    storeRelease(cqHead_, head);
+    return n;
+}
+
+bool IoUring::registerBuffers(uint16_t group, uint8_t* base, unsigned count, unsigned size) {
+    if (count == 0 || (count & (count - 1)) != 0 || count > 32768) return false;
+
+    bufRingSize_ = count * sizeof(io_uring_buf);
+    void* ring = mmap(nullptr, bufRingSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) return false;
+    bufRing_ = ring;
+
+    io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+    reg.ring_entries = count;
+    reg.bgid = group;
+    if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        return false;   // pre-5.19 kernel
+    }
+
+    bufBase_ = base;
+    bufCount_ = count;
+    bufSize_ = size;
+    bufGroup_ = group;
+    bufTail_ = 0;
+    for (unsigned i = 0; i < count; ++i) recycleBuffer(static_cast<uint16_t>(i));
+    publishBuffers();
+    return true;
+}
+
+// The buffer ring is a plain array of io_uring_buf whose first entry's resv field doubles as
+// the tail. io_uring_buf_ring itself can't be used from C++: its flexible array wrapper
+// has a non-zero-sized empty member there, which moves `bufs` to offset 8.
+void IoUring::recycleBuffer(uint16_t id) {
+    io_uring_buf& buf = static_cast<io_uring_buf*>(bufRing_)[bufTail_ & (bufCount_ - 1)];
+    buf.addr = reinterpret_cast<uint64_t>(bufBase_ + static_cast<size_t>(id) * bufSize_);
+    buf.len = bufSize_;
+    buf.bid = id;
+    ++bufTail_;
+}
+
+void IoUring::publishBuffers() {
+    uint16_t* tail = &static_cast<io_uring_buf*>(bufRing_)[0].resv;
+    __atomic_store_n(tail, bufTail_, __ATOMIC_RELEASE);
+}
+
+bool IoUring::hasBuffer(const UringCompletion& c) { return (c.flags & IORING_CQE_F_BUFFER) != 0; }
+uint16_t IoUring::bufferId(const UringCompletion& c) { return static_cast<uint16_t>(c.flags >> IORING_CQE_BUFFER_SHIFT); }
+bool IoUring::hasMore(const UringCompletion& c) { return (c.flags & IORING_CQE_F_MORE) != 0; }
+
+size_t IoUring::recvBufferSize(const msghdr& layout, size_t payloadSize) {
+    return sizeof(io_uring_recvmsg_out) + layout.msg_namelen + layout.msg_controllen + payloadSize;
+}
+
+// Each buffer holds io_uring_recvmsg_out, then the sender and control space `layout`
+// reserved (whatever the kernel actually filled), then the datagram
+bool IoUring::splitRecvMsg(uint8_t* buffer, const msghdr& layout, msghdr& out,
+                           uint8_t** payload, size_t* payloadSize) {
+    io_uring_recvmsg_out header;
+    std::memcpy(&header, buffer, sizeof(header));
+    uint8_t* name = buffer + sizeof(header);
+
+    std::memset(&out, 0, sizeof(out));
+    out.msg_name = name;
+    out.msg_namelen = header.namelen < layout.msg_namelen ? header.namelen : layout.msg_namelen;
+    out.msg_control = header.controllen ? name + layout.msg_namelen : nullptr;
+    out.msg_controllen = header.controllen;
+    out.msg_flags = static_cast<int>(header.flags);
+
+    *payload = name + layout.msg_namelen + layout.msg_controllen;
+    *payloadSize = header.payloadlen;
+    return (header.flags & MSG_TRUNC) == 0;
+}
+
+#else
+
+// No io_uring outside Linux: init() fails and callers stay on their plain syscall path
+IoUring::~IoUring() {}
+void IoUring::teardown() {}
+bool IoUring::init(unsigned) { return false; }
+bool IoUring::queueRecvMsgMultishot(int, const msghdr*, uint16_t, uint64_t) { return false; }
+bool IoUring::queueWrite(int, const void*, uint32_t, uint64_t, uint64_t, bool) { return false; }
+bool IoUring::submit(unsigned, int) { return false; }
+size_t IoUring::reap(UringCompletion*, size_t) { return 0; }
+bool IoUring::registerBuffers(uint16_t, uint8_t*, unsigned, unsigned) { return false; }
+void IoUring::recycleBuffer(uint16_t) {}
+void IoUring::publishBuffers() {}
+bool IoUring::hasBuffer(const UringCompletion&) { return false; }
+uint16_t IoUring::bufferId(const UringCompletion&) { return 0; }
+bool IoUring::hasMore(const UringCompletion&) { return false; }
+size_t IoUring::recvBufferSize(const msghdr&, size_t) { return 0; }
+bool IoUring::splitRecvMsg(uint8_t*, const msghdr&, msghdr&, uint8_t**, size_t*) { return false; }
+
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+struct msghdr;
+
+// One completion taken off the ring
+struct UringCompletion {
+    uint64_t userData;
+    int32_t result;    // bytes or count, or -errno
+    uint32_t flags;    // IORING_CQE_F_*
+};
+
+// Minimal io_uring over the raw syscalls (no liburing): one submission / completion ring
+// pair, owned and driven by a single thread. init() fails, and the caller keeps its plain
+// syscall path, on anything but Linux 6.0+ (multishot recvmsg, provided buffer rings) or
+// where io_uring is turned off (kernel.io_uring_disabled, container seccomp profiles).
+class IoUring {
+public:
+    IoUring() = default;
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    bool init(unsigned entries);
+    bool ready() const { return fd_ >= 0; }
+
+    // Queue a request for the next submit(); false when the submission ring is full.
+    // Multishot recvmsg keeps completing, one datagram per completion, into buffers picked
+    // from `bufferGroup`; `layout` gives the name / control space reserved in each buffer.
+    bool queueRecvMsgMultishot(int sock, const msghdr* layout, uint16_t bufferGroup, uint64_t userData);
+    // Linked writes run in queue order, and a failed one cancels the rest of its chain
+    bool queueWrite(int fd, const void* data, uint32_t size, uint64_t offset, uint64_t userData, bool linkNext);
+
+    // Hand everything queued to the kernel and wait for `waitFor` completions, at most
+    // timeoutMs (-1 = no limit). One io_uring_enter; false only on a hard error.
+    bool submit(unsigned waitFor = 0, int timeoutMs = -1);
+    size_t reap(UringCompletion* out, size_t maxCount);
+    unsigned queued() const { return sqTail_ - submitted_; }
+
+    // Provided buffers for multishot receive: `count` (a power of two) buffers of `size`
+    // bytes starting at `base`, all handed to the kernel
+    bool registerBuffers(uint16_t group, uint8_t* base, unsigned count, unsigned size);
+    void recycleBuffer(uint16_t id);   // a consumed buffer goes back; visible after publishBuffers()
+    void publishBuffers();
+
+    static bool hasBuffer(const UringCompletion& c);
+    static uint16_t bufferId(const UringCompletion& c);
+    static bool hasMore(const UringCompletion& c);   // false: a multishot request ended, re-arm it
+
+    // Bytes a provided buffer needs for one datagram received with `layout`
+    static size_t recvBufferSize(const msghdr& layout, size_t payloadSize);
+    // Splits a multishot recvmsg buffer into the sender / control parts of `out` and the
+    // payload; false if the datagram was truncated
+    static bool splitRecvMsg(uint8_t* buffer, const msghdr& layout, msghdr& out,
+                             uint8_t** payload, size_t* payloadSize);
+
+private:
+    void teardown();
+
+    int fd_ = -1;
+    unsigned features_ = 0;
+
+    // Mapped rings (see io_uring_setup(2))
+    void* sqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    void* cqRing_ = nullptr;
+    size_t cqRingSize_ = 0;
+    void* sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqKernelTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned sqEntries_ = 0;
+    unsigned* sqArray_ = nullptr;
+    unsigned sqTail_ = 0;        // next free entry, published to the kernel by submit()
+    unsigned submitted_ = 0;
+
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    void* cqes_ = nullptr;
+
+    // Provided buffer ring
+    void* bufRing_ = nullptr;
+    size_t bufRingSize_ = 0;
+    uint8_t* bufBase_ = nullptr;
+    unsigned bufCount_ = 0;
+    unsigned bufSize_ = 0;
+    uint16_t bufGroup_ = 0;
+    uint16_t bufTail_ = 0;
+};
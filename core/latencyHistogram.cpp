@@ -0,0 +1,93 @@
+#include "latencyHistogram.hpp"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+
+LatencyHistogram g_latency[NUM_LATENCY_STAGES];
+
+const char* latencyStageName(LatencyStage stage) {
+    switch (stage) {
+        case LATENCY_DECODE: return "receive->decode";
+        case LATENCY_RING_PUSH: return "receive->ring push";
+        case LATENCY_RENDER: return "receive->render";
+        default: return "unknown";
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+    total_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Summary LatencyHistogram::summary() const {
+    Summary s = {};
+    uint64_t counts[kNumBuckets];
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        counts[i] = counts_[i].load(std::memory_order_relaxed);
+        s.count += counts[i];
+    }
+    s.maxNs = max_.load(std::memory_order_relaxed);
+    if (s.count == 0) return s;
+    s.meanNs = static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(s.count);
+
+    const double percentiles[] = {50.0, 90.0, 99.0, 99.9};
+    uint64_t* out[] = {&s.p50Ns, &s.p90Ns, &s.p99Ns, &s.p999Ns};
+    size_t next = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets && next < 4; ++i) {
+        seen += counts[i];
+        while (next < 4 && seen >= static_cast<uint64_t>(std::ceil(percentiles[next] / 100.0 * s.count))) {
+            *out[next++] = bucketHigh(i) < s.maxNs ? bucketHigh(i) : s.maxNs;
+        }
+    }
+    return s;
+}
+
+void LatencyHistogram::writePercentiles(std::ostream& out) const {
+    uint64_t counts[kNumBuckets];
+    uint64_t total = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        counts[i] = counts_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    out << std::setw(12) << "Value" << std::setw(15) << "Percentile" << std::setw(11) << "TotalCount"
+        << std::setw(18) << "1/(1-Percentile)" << "\n\n";
+    if (total == 0) return;
+
+    out << std::fixed;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        if (counts[i] == 0) continue;
+        seen += counts[i];
+        double percentile = static_cast<double>(seen) / static_cast<double>(total);
+        out << std::setw(12) << std::setprecision(3) << bucketHigh(i) / 1000.0
+            << std::setw(15) << std::setprecision(12) << percentile
+            << std::setw(11) << seen;
+        if (seen < total) out << std::setw(18) << std::setprecision(2) << 1.0 / (1.0 - percentile);
+        out << "\n";
+    }
+
+    Summary s = summary();
+    out << std::setprecision(3)
+        << "#[Mean    = " << std::setw(12) << s.meanNs / 1000.0 << ", Max = " << std::setw(12) << s.maxNs / 1000.0 << "]\n"
+        << "#[Total count    = " << std::setw(12) << total << ", SubBuckets = " << std::setw(4) << kSubBuckets << "]\n";
+}
+
+bool writeLatencyReport(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to open latency report " << path << "\n";
+        return false;
+    }
+    for (size_t stage = 0; stage < NUM_LATENCY_STAGES; ++stage) {
+        out << "# Stage: " << latencyStageName(static_cast<LatencyStage>(stage)) << " (microseconds)\n";
+        g_latency[stage].writePercentiles(out);
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// steady_clock nanoseconds; every latency in the pipeline is measured on this clock
+inline uint64_t monotonicNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// HDR-style log-linear histogram of nanosecond latencies: exact below 64 ns, then 64
+// linear sub-buckets per power of two (~1.6% resolution) up to 2^40 ns (~18 min).
+// record() is lock-free and may run on several threads; reads are approximate while
+// values are still being recorded.
+class LatencyHistogram {
+public:
+    struct Summary {
+        uint64_t count;
+        double meanNs;
+        uint64_t p50Ns;
+        uint64_t p90Ns;
+        uint64_t p99Ns;
+        uint64_t p999Ns;
+        uint64_t maxNs;
+    };
+
+    void record(uint64_t ns) {
+        counts_[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        total_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        while (ns > max && !max_.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+    }
+
+    void reset();
+
+    uint64_t count() const { return total_.load(std::memory_order_relaxed); }
+    Summary summary() const;
+
+    // Highest value that lands in the bucket of `ns` (what percentiles report)
+    static uint64_t highestEquivalent(uint64_t ns) { return bucketHigh(bucketIndex(ns)); }
+
+    // HdrHistogram .hgrm-style percentile distribution, values in microseconds
+    void writePercentiles(std::ostream& out) const;
+
+private:
+    static constexpr unsigned kSubBits = 6;
+    static constexpr uint64_t kSubBuckets = 1ull << kSubBits;
+    static constexpr unsigned kMaxMsb = 40;
+    static constexpr size_t kNumBuckets = kSubBuckets + (kMaxMsb - kSubBits + 1) * kSubBuckets;
+
+    static size_t bucketIndex(uint64_t ns) {
+        if (ns < kSubBuckets) return static_cast<size_t>(ns);
+        unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(ns));
+        if (msb > kMaxMsb) return kNumBuckets - 1;
+        unsigned shift = msb - kSubBits;
+        return static_cast<size_t>(kSubBuckets + shift * kSubBuckets + ((ns >> shift) - kSubBuckets));
+    }
+
+    static uint64_t bucketHigh(size_t index) {
+        if (index < kSubBuckets) return index;
+        uint64_t shift = (index - kSubBuckets) / kSubBuckets;
+        uint64_t sub = (index - kSubBuckets) % kSubBuckets;
+        return ((kSubBuckets + sub + 1) << shift) - 1;
+    }
+
+    std::atomic<uint64_t> counts_[kNumBuckets] = {};
+    std::atomic<uint64_t> total_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Where a telemetry sample is on its way from the NIC to the screen; every stage is
+// measured from the kernel receive timestamp
+enum LatencyStage : uint8_t {
+    LATENCY_DECODE = 0,      // validated and handed to the bus
+    LATENCY_RING_PUSH = 1,   // player sample pushed into its session's input ring
+    LATENCY_RENDER = 2,      // first frame that plotted the sample was presented
+    NUM_LATENCY_STAGES
+};
+
+const char* latencyStageName(LatencyStage stage);
+
+extern LatencyHistogram g_latency[NUM_LATENCY_STAGES];
+
+// Write every stage's percentile distribution to `path`; false (and a message) on failure
+bool writeLatencyReport(const std::string& path);
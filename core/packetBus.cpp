@@ -0,0 +1,84 @@
+#include "packetBus.hpp"
+#include <chrono>
+
+PacketBus g_packetBus;
+
+PacketBus::~PacketBus() {
+    stop();
+}
+
+void PacketBus::subscribeRaw(const std::string& name, uint32_t mask, RawHandler handler,
+                             BusDelivery delivery, size_t queueCapacity) {
+    std::unique_ptr<Subscriber> sub(new Subscriber);
+    sub->name = name;
+    sub->mask = mask & kAllPackets;
+    sub->handler = std::move(handler);
+    sub->delivery = delivery;
+
+    if (delivery == BusDelivery::Worker) {
+        sub->queue.reset(new PacketQueue(queueCapacity));
+        sub->running.store(true, std::memory_order_release);
+        sub->worker = std::thread(&PacketBus::runWorker, sub.get());
+    }
+
+    for (size_t id = 0; id < kNumPacketTypes; ++id) {
+        if (sub->mask & (1u << id)) {
+            byType_[id].push_back(sub.get());
+        }
+    }
+    subscribers_.push_back(std::move(sub));
+}
+
+void PacketBus::publish(const PacketTypeInfo& info, const uint8_t* data, size_t size, const ReceiveInfo& received) {
+    for (Subscriber* sub : byType_[info.id]) {
+        if (sub->delivery == BusDelivery::Inline) {
+            sub->handler(data, size, received);
+            sub->delivered.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            std::lock_guard<std::mutex> lock(sub->pushMutex);
+            if (!sub->queue->tryPush(data, size, received)) {
+                sub->dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+void PacketBus::runWorker(Subscriber* sub) {
+    // Keep draining after stop() so nothing already queued is lost
+    while (sub->running.load(std::memory_order_acquire) || sub->queue->front() != nullptr) {
+        const PacketSlot* slot = sub->queue->front();
+        if (!slot) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        sub->handler(slot->data, slot->size, slot->received);
+        sub->queue->pop();
+        sub->delivered.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void PacketBus::stop() {
+    for (auto& sub : subscribers_) {
+        if (sub->worker.joinable()) {
+            sub->running.store(false, std::memory_order_release);
+            sub->worker.join();
+        }
+    }
+}
+
+std::vector<BusSubscriberStats> PacketBus::stats() const {
+    std::vector<BusSubscriberStats> out;
+    stats(out);
+    return out;
+}
+
+void PacketBus::stats(std::vector<BusSubscriberStats>& out) const {
+    out.resize(subscribers_.size());
+    for (size_t i = 0; i < subscribers_.size(); ++i) {
+        const Subscriber& sub = *subscribers_[i];
+        out[i].name = sub.name;
+        out[i].delivery = sub.delivery;
+        out[i].delivered = sub.delivered.load(std::memory_order_relaxed);
+        out[i].dropped = sub.dropped.load(std::memory_order_relaxed);
+    }
+}
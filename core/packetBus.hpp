@@ -0,0 +1,113 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "packetStructs.hpp"
+#include "packetDispatch.hpp"
+#include "packetQueue.hpp"
+
+// ===================== PACKET TRAITS =====================
+
+template<typename T> struct PacketTraits;
+template<> struct PacketTraits<PacketMotionData>              { static constexpr PacketID id = MOTION; };
+template<> struct PacketTraits<PacketSessionData>             { static constexpr PacketID id = SESSION; };
+template<> struct PacketTraits<PacketLapData>                 { static constexpr PacketID id = LAP_DATA; };
+template<> struct PacketTraits<PacketEventData>               { static constexpr PacketID id = EVENT; };
+template<> struct PacketTraits<PacketParticipantsData>        { static constexpr PacketID id = PARTICIPANTS; };
+template<> struct PacketTraits<PacketCarSetupData>            { static constexpr PacketID id = CAR_SETUPS; };
+template<> struct PacketTraits<PacketCarTelemetryData>        { static constexpr PacketID id = CAR_TELEMETRY; };
+template<> struct PacketTraits<PacketCarStatusData>           { static constexpr PacketID id = CAR_STATUS; };
+template<> struct PacketTraits<PacketFinalClassificationData> { static constexpr PacketID id = FINAL_CLASSIFICATION; };
+template<> struct PacketTraits<PacketLobbyInfoData>           { static constexpr PacketID id = LOBBY_INFO; };
+template<> struct PacketTraits<PacketCarDamageData>           { static constexpr PacketID id = CAR_DAMAGE; };
+template<> struct PacketTraits<PacketSessionHistoryData>      { static constexpr PacketID id = SESSION_HISTORY; };
+template<> struct PacketTraits<PacketTyreSetsData>            { static constexpr PacketID id = TYRE_SETS; };
+template<> struct PacketTraits<PacketMotionExData>            { static constexpr PacketID id = MOTION_EX; };
+
+constexpr uint32_t packetMask(PacketID id) { return 1u << id; }
+constexpr uint32_t kAllPackets = (1u << kNumPacketTypes) - 1;
+
+// ===================== BUS =====================
+
+enum class BusDelivery : uint8_t {
+    Inline,   // handler runs on the publishing (ingest) thread, straight from the receive slab
+    Worker    // packet is copied into the subscriber's own queue and handled on its own thread
+};
+
+struct BusSubscriberStats {
+    std::string name;
+    BusDelivery delivery;
+    uint64_t delivered;
+    uint64_t dropped;     // worker queue was full
+};
+
+// Typed publish/subscribe fan-out of validated packets. Subscribe everything before the
+// listener starts. publish() runs on every listener thread: an inline handler may see two
+// streams at once on different threads, never one stream on two. Pushing into a worker
+// queue is the only lock it takes.
+class PacketBus {
+public:
+    using RawHandler = std::function<void(const uint8_t* data, size_t size, const ReceiveInfo& received)>;
+
+    PacketBus() = default;
+    ~PacketBus();
+
+    PacketBus(const PacketBus&) = delete;
+    PacketBus& operator=(const PacketBus&) = delete;
+
+    // Receive `const T&` views of one packet type. The handler takes (const T&) or
+    // (const T&, const ReceiveInfo&).
+    template<typename T, typename F>
+    void subscribe(const std::string& name, F handler, BusDelivery delivery = BusDelivery::Inline,
+                   size_t queueCapacity = 1024) {
+        subscribeRaw(name, packetMask(PacketTraits<T>::id),
+                     [handler](const uint8_t* data, size_t, const ReceiveInfo& received) {
+                         const T& packet = *reinterpret_cast<const T*>(data);
+                         if constexpr (std::is_invocable<F, const T&, const ReceiveInfo&>::value) {
+                             handler(packet, received);
+                         } else {
+                             handler(packet);
+                         }
+                     },
+                     delivery, queueCapacity);
+    }
+
+    // Receive the raw bytes of every packet type in `mask`
+    void subscribeRaw(const std::string& name, uint32_t mask, RawHandler handler,
+                      BusDelivery delivery = BusDelivery::Inline, size_t queueCapacity = 1024);
+
+    void publish(const PacketTypeInfo& info, const uint8_t* data, size_t size, const ReceiveInfo& received);
+
+    void stop();   // drains and joins worker subscribers
+
+    std::vector<BusSubscriberStats> stats() const;
+    void stats(std::vector<BusSubscriberStats>& out) const;   // reuses out's storage: no allocation once sized
+
+private:
+    struct Subscriber {
+        std::string name;
+        uint32_t mask;
+        RawHandler handler;
+        BusDelivery delivery;
+        std::unique_ptr<PacketQueue> queue;
+        std::mutex pushMutex;   // the queue has one producer slot; listeners take turns
+        std::thread worker;
+        std::atomic<bool> running{false};
+        std::atomic<uint64_t> delivered{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    static void runWorker(Subscriber* sub);
+
+    std::vector<std::unique_ptr<Subscriber>> subscribers_;
+    std::vector<Subscriber*> byType_[kNumPacketTypes];
+};
+
+extern PacketBus g_packetBus;
@@ -0,0 +1,89 @@
+#include "packetDispatch.hpp"
+#include "packetStructs.hpp"
+
+// ===================== SPEC SIZES =====================
+// Packed sizes from the F1 23 UDP specification. A mismatch here means a struct in
+// packetStructs.hpp drifted from the wire format.
+
+static_assert(sizeof(PacketHeader) == 29, "PacketHeader must be 29 bytes");
+static_assert(sizeof(PacketMotionData) == 1349, "PacketMotionData must be 1349 bytes");
+static_assert(sizeof(PacketSessionData) == 644, "PacketSessionData must be 644 bytes");
+static_assert(sizeof(PacketLapData) == 1131, "PacketLapData must be 1131 bytes");
+static_assert(sizeof(PacketEventData) == 45, "PacketEventData must be 45 bytes");
+static_assert(sizeof(PacketParticipantsData) == 1306, "PacketParticipantsData must be 1306 bytes");
+static_assert(sizeof(PacketCarSetupData) == 1107, "PacketCarSetupData must be 1107 bytes");
+static_assert(sizeof(PacketCarTelemetryData) == 1352, "PacketCarTelemetryData must be 1352 bytes");
+static_assert(sizeof(PacketCarStatusData) == 1239, "PacketCarStatusData must be 1239 bytes");
+static_assert(sizeof(PacketFinalClassificationData) == 1020, "PacketFinalClassificationData must be 1020 bytes");
+static_assert(sizeof(PacketLobbyInfoData) == 1218, "PacketLobbyInfoData must be 1218 bytes");
+static_assert(sizeof(PacketCarDamageData) == 953, "PacketCarDamageData must be 953 bytes");
+static_assert(sizeof(PacketSessionHistoryData) == 1460, "PacketSessionHistoryData must be 1460 bytes");
+static_assert(sizeof(PacketTyreSetsData) == 231, "PacketTyreSetsData must be 231 bytes");
+static_assert(sizeof(PacketMotionExData) == 217, "PacketMotionExData must be 217 bytes");
+
+// ===================== DISPATCH TABLE =====================
+
+// Events, session history and tyre sets can arrive several times in one frame
+// (one event / one car per packet); everything else is sent at most once per frame.
+static constexpr PacketTypeInfo kPacketTypes[kNumPacketTypes] = {
+    {MOTION,               "motion",               sizeof(PacketMotionData),              &writeMotionPacket,              true},
+    {SESSION,              "session",              sizeof(PacketSessionData),             &writeSessionPacket,             true},
+    {LAP_DATA,             "lap_data",             sizeof(PacketLapData),                 &writeLapDataPacket,             true},
+    {EVENT,                "event",                sizeof(PacketEventData),               &writeEventPacket,               false},
+    {PARTICIPANTS,         "participants",         sizeof(PacketParticipantsData),        &writeParticipantsPacket,        true},
+    {CAR_SETUPS,           "car_setups",           sizeof(PacketCarSetupData),            &writeCarSetupsPacket,           true},
+    {CAR_TELEMETRY,        "car_telemetry",        sizeof(PacketCarTelemetryData),        &writeCarTelemetryPacket,        true},
+    {CAR_STATUS,           "car_status",           sizeof(PacketCarStatusData),           &writeCarStatusPacket,           true},
+    {FINAL_CLASSIFICATION, "final_classification", sizeof(PacketFinalClassificationData), &writeFinalClassificationPacket, true},
+    {LOBBY_INFO,           "lobby_info",           sizeof(PacketLobbyInfoData),           &writeLobbyInfoPacket,           true},
+    {CAR_DAMAGE,           "car_damage",           sizeof(PacketCarDamageData),           &writeCarDamagePacket,           true},
+    {SESSION_HISTORY,      "session_history",      sizeof(PacketSessionHistoryData),      &writeSessionHistoryPacket,      false},
+    {TYRE_SETS,            "tyre_sets",            sizeof(PacketTyreSetsData),            &writeTyreSetsPacket,            false},
+    {MOTION_EX,            "motion_ex",            sizeof(PacketMotionExData),            &writeMotionExPacket,            true},
+};
+
+static constexpr bool tableIndexedById() {
+    for (size_t i = 0; i < kNumPacketTypes; ++i) {
+        if (kPacketTypes[i].id != i || kPacketTypes[i].writer == nullptr) return false;
+    }
+    return true;
+}
+static_assert(tableIndexedById(), "kPacketTypes rows must be in PacketID order with a writer each");
+
+const PacketTypeInfo* packetTypeInfo(uint8_t packetId) {
+    return packetId < kNumPacketTypes ? &kPacketTypes[packetId] : nullptr;
+}
+
+const PacketTypeInfo* validatePacket(const uint8_t* data, size_t size, PacketReject* reason) {
+    PacketReject r = PacketReject::None;
+    const PacketTypeInfo* info = nullptr;
+
+    if (size < sizeof(PacketHeader)) {
+        r = PacketReject::TooShort;
+    } else {
+        const PacketHeader* header = reinterpret_cast<const PacketHeader*>(data);
+        if (header->m_packetFormat != 2023) {
+            r = PacketReject::BadFormat;
+        } else if (header->m_packetId >= kNumPacketTypes) {
+            r = PacketReject::UnknownId;
+        } else if (size != kPacketTypes[header->m_packetId].size) {
+            r = PacketReject::SizeMismatch;
+        } else {
+            info = &kPacketTypes[header->m_packetId];
+        }
+    }
+
+    if (reason) *reason = r;
+    return info;
+}
+
+const char* packetRejectName(PacketReject reason) {
+    switch (reason) {
+        case PacketReject::None: return "none";
+        case PacketReject::TooShort: return "too short for header";
+        case PacketReject::BadFormat: return "invalid packet format";
+        case PacketReject::UnknownId: return "unknown packet id";
+        case PacketReject::SizeMismatch: return "size mismatch";
+    }
+    return "unknown";
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include "packetWriters.hpp"
+
+using PacketTextWriter = void (*)(const uint8_t* data, std::ofstream& file);
+
+// One row of the dispatch table, indexed by PacketID
+struct PacketTypeInfo {
+    PacketID id;
+    const char* name;          // also the text log file name
+    size_t size;               // exact packed size per the F1 23 UDP spec
+    PacketTextWriter writer;   // text formatting for logs / render_capture
+    bool oncePerFrame;         // at most one per frame, so frame ids form a sequence
+};
+
+constexpr size_t kNumPacketTypes = 14;
+
+enum class PacketReject : uint8_t {
+    None,
+    TooShort,       // smaller than a PacketHeader
+    BadFormat,      // m_packetFormat != 2023
+    UnknownId,      // m_packetId outside the table
+    SizeMismatch    // datagram size differs from the spec size for its id
+};
+
+// O(1) check that a datagram is a complete, known 2023 packet. Returns nullptr (and the
+// reason) when it must not be handed to any handler.
+const PacketTypeInfo* validatePacket(const uint8_t* data, size_t size, PacketReject* reason = nullptr);
+
+// Table row for a packet id, nullptr for unknown ids
+const PacketTypeInfo* packetTypeInfo(uint8_t packetId);
+
+const char* packetRejectName(PacketReject reason);
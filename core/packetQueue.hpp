@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+// When a datagram arrived, taken from the kernel receive timestamp when the socket has one,
+// and who sent it. The source is zero for replayed packets.
+struct ReceiveInfo {
+    uint64_t wallNs;   // system_clock, what capture files record
+    uint64_t monoNs;   // steady_clock, what latency is measured against
+    uint32_t sourceAddress = 0;   // IPv4, network byte order
+    uint16_t sourcePort = 0;      // network byte order
+};
+
+// One received datagram plus its receive timestamp
+struct PacketSlot {
+    static constexpr size_t kMaxSize = 2048;   // F1 23 packets top out at ~1.5 KB
+
+    ReceiveInfo received;
+    uint16_t size;
+    uint8_t data[kMaxSize];
+};
+
+// Bounded lock-free single-producer / single-consumer queue of packet slots.
+// Slots are allocated once; a push into a full queue fails and the caller counts the drop.
+class PacketQueue {
+public:
+    explicit PacketQueue(size_t capacity) {
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        slots_.reset(new PacketSlot[cap]);
+        mask_ = cap - 1;
+    }
+
+    // Producer side
+    bool tryPush(const uint8_t* data, size_t size, const ReceiveInfo& received) {
+        if (size > PacketSlot::kMaxSize) return false;
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) > mask_) return false;
+
+        PacketSlot& slot = slots_[tail & mask_];
+        slot.received = received;
+        slot.size = static_cast<uint16_t>(size);
+        std::memcpy(slot.data, data, size);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: oldest queued slot, or nullptr when empty. Valid until pop().
+    const PacketSlot* front() const {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) return nullptr;
+        return &slots_[head & mask_];
+    }
+
+    void pop() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::unique_ptr<PacketSlot[]> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0};   // consumer index
+    alignas(64) std::atomic<size_t> tail_{0};   // producer index
+};
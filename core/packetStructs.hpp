@@ -1,6 +1,10 @@
+#pragma once
 #include <cstdint>
+#include <cstddef>
 #include <iostream>
 
+constexpr size_t kMaxCars = 22;   // length of every per-car array in the packets
+
 #pragma pack(push, 1)
 
 struct PacketHeader
@@ -31,11 +35,25 @@ struct CarTelemetryData {
     uint16_t m_engineRPM;          // RPM
     uint8_t  m_drs;                // 0 = off, 1 = on
     uint8_t  m_revLightsPercent;   // 0 - 100
+    uint16_t m_revLightsBitValue;  // Rev lights (bit 0 = leftmost LED, bit 14 = rightmost LED)
+    uint16_t m_brakesTemperature[4];       // Brakes temperature (celsius)
+    uint8_t  m_tyresSurfaceTemperature[4]; // Tyres surface temperature (celsius)
+    uint8_t  m_tyresInnerTemperature[4];   // Tyres inner temperature (celsius)
+    uint16_t m_engineTemperature;          // Engine temperature (celsius)
+    float    m_tyresPressure[4];           // Tyres pressure (PSI)
+    uint8_t  m_surfaceType[4];             // Driving surface, see appendices
 };
 
 struct PacketCarTelemetryData {
     PacketHeader      m_header;
     CarTelemetryData  m_carTelemetryData[22];
+
+    uint8_t           m_mfdPanelIndex;       // Index of MFD panel open - 255 = MFD closed
+                                             // Single player, race – 0 = Car setup, 1 = Pits
+                                             // 2 = Damage, 3 =  Engine, 4 = Temperatures
+    uint8_t           m_mfdPanelIndexSecondaryPlayer;   // See above
+    int8_t            m_suggestedGear;       // Suggested gear for the player (1-8)
+                                             // 0 if no gear suggested
 };
 
 struct CarMotionData
@@ -3,12 +3,20 @@
 #include <iomanip>
 #include "packetStructs.hpp"
 #include "packetWriters.hpp"
-#include "../live/LiveTelemetry.hpp"
+#include "packetDispatch.hpp"
 
 #include <string>
 #include <unordered_map>
 #include <cstring>
 
+// Helper function to get packet type name
+std::string getPacketTypeName(uint8_t packetId) {
+    const PacketTypeInfo* info = packetTypeInfo(packetId);
+    return info ? info->name : "unknown";
+}
+
+// ===================== TEXT WRITERS =====================
+
 void writeCarTelemetryPacket(const uint8_t* data, std::ofstream& file) {
     if (!data || !file.is_open()) {
         file << "Invalid car telemetry packet data\n";
@@ -20,24 +28,6 @@ void writeCarTelemetryPacket(const uint8_t* data, std::ofstream& file) {
         if (i != packet->m_header.m_playerCarIndex) continue;
         const CarTelemetryData& carData = packet->m_carTelemetryData[i];
 
-        LiveInputSample sample;
-
-        sample.throttle = carData.m_throttle;
-        sample.brake = carData.m_brake;
-        sample.steer = carData.m_steer;
-        sample.timestampMs = static_cast<uint64_t>(packet->m_header.m_sessionTime*1000);
-
-        // Populate extended telemetry fields
-        sample.speed = carData.m_speed;
-        sample.engineRPM = carData.m_engineRPM;
-        // Store clutch as an integer percentage to avoid noisy floating prints
-        sample.clutch = static_cast<uint8_t>(static_cast<int>(carData.m_clutch));
-        sample.gear = carData.m_gear;
-        sample.drs = carData.m_drs;
-        sample.revLightsPercent = carData.m_revLightsPercent;
-
-        g_liveInputs.push(sample);
-
         file << "Car " << i << ":\n";
         file << "  Speed: " << carData.m_speed << " km/h\n";
         file << "  Throttle: " << std::fixed << std::setprecision(4) << carData.m_throttle * 100 << "%\n";
@@ -170,29 +160,25 @@ void writeMotionPacket(const uint8_t* data, std::ofstream& file) {
 
     const PacketMotionData* packet = reinterpret_cast<const PacketMotionData*>(data);
 
-    const CarMotionData& motionData = packet->m_carMotionData[packet->m_header.m_playerCarIndex];
-
-    g_livePositions.push({
-        motionData.m_worldPositionX,
-        motionData.m_worldPositionY,
-        motionData.m_worldPositionZ,
-        static_cast<uint64_t>(packet->m_header.m_sessionTime * 1000)
-    });
-
-    file << "  Position: (" << std::fixed << std::setprecision(2) 
-            << motionData.m_worldPositionX << ", "
-            << motionData.m_worldPositionY << ", "
-            << motionData.m_worldPositionZ << ") m\n";
-    file << "  Velocity: (" << std::setprecision(2)
-            << motionData.m_worldVelocityX << ", "
-            << motionData.m_worldVelocityY << ", "
-            << motionData.m_worldVelocityZ << ") m/s\n";
-    file << "  G-Forces - Lateral: " << std::setprecision(3) << motionData.m_gForceLateral
-            << ", Longitudinal: " << motionData.m_gForceLongitudinal
-            << ", Vertical: " << motionData.m_gForceVertical << "\n";
-    file << "  Rotation (rad) - Yaw: " << std::setprecision(4) << motionData.m_yaw
-            << ", Pitch: " << motionData.m_pitch
-            << ", Roll: " << motionData.m_roll << "\n";
+    for (int i = 0; i < 22; ++i) {
+        if (i != packet->m_header.m_playerCarIndex) continue;
+        const CarMotionData& motionData = packet->m_carMotionData[i];
+
+        file << "  Position: (" << std::fixed << std::setprecision(2) 
+                << motionData.m_worldPositionX << ", "
+                << motionData.m_worldPositionY << ", "
+                << motionData.m_worldPositionZ << ") m\n";
+        file << "  Velocity: (" << std::setprecision(2)
+                << motionData.m_worldVelocityX << ", "
+                << motionData.m_worldVelocityY << ", "
+                << motionData.m_worldVelocityZ << ") m/s\n";
+        file << "  G-Forces - Lateral: " << std::setprecision(3) << motionData.m_gForceLateral
+                << ", Longitudinal: " << motionData.m_gForceLongitudinal
+                << ", Vertical: " << motionData.m_gForceVertical << "\n";
+        file << "  Rotation (rad) - Yaw: " << std::setprecision(4) << motionData.m_yaw
+                << ", Pitch: " << motionData.m_pitch
+                << ", Roll: " << motionData.m_roll << "\n";
+    }
     file << "\n";
 }
 
@@ -209,9 +195,6 @@ void writeSessionPacket(const uint8_t* data, std::ofstream& file) {
     file << "  Session Duration: " << packet->m_sessionDuration << " s\n";
     file << "  Pit Speed Limit: " << static_cast<int>(packet->m_pitSpeedLimit) << " km/h\n";
     file << "  Track ID: " << static_cast<int>(packet->m_trackId) << "\n";
-    if(packet->m_trackId != g_staticInfo.track_id) {
-        g_staticInfo.track_id = packet->m_trackId;
-    }
 }
 
 void writeLapDataPacket(const uint8_t* data, std::ofstream& file) {
@@ -394,3 +377,12 @@ void writeMotionExPacket(const uint8_t* data, std::ofstream& file) {
     file << "  FrontWheelsAngle=" << packet->m_frontWheelsAngle << "\n";
 }
 
+void callPacketTypeWriter(const uint8_t* data, std::ofstream& file, uint8_t packetId) {
+    const PacketTypeInfo* info = packetTypeInfo(packetId);
+    if (info) {
+        info->writer(data, file);
+    } else {
+        file << "Unknown packet type: " << static_cast<int>(packetId);
+    }
+    file << "\n";
+}
@@ -0,0 +1,110 @@
+#include "sequenceTracker.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+SequenceTracker g_sequenceTracker;
+
+void SequenceTracker::onFlashback(FlashbackHandler handler) {
+    handlers_.push_back(std::move(handler));
+}
+
+SequenceTracker::Stream& SequenceTracker::streamFor(Shard& shard, const PacketHeader& header,
+                                                    const ReceiveInfo& received) {
+    Stream* streams = shard.streams;
+    if (streams[shard.lastStream].matches(header, received)) {
+        return streams[shard.lastStream];
+    }
+
+    for (size_t i = 0; i < kMaxStreams; ++i) {
+        if (streams[i].matches(header, received)) {
+            shard.lastStream = i;
+            return streams[i];
+        }
+    }
+
+    // New stream (new sender, or a new session / restart): frame ids start over and are
+    // not a flashback. Takes a free slot, else the one idle longest.
+    size_t slot = 0;
+    for (size_t i = 1; i < kMaxStreams && streams[slot].active; ++i) {
+        if (!streams[i].active || streams[i].lastSeenNs < streams[slot].lastSeenNs) slot = i;
+    }
+    if (streams[slot].active) bump(stats_.streamsEvicted);
+    Stream& stream = streams[slot];
+    stream = Stream{};
+    stream.active = true;
+    stream.sourceAddress = received.sourceAddress;
+    stream.sourcePort = received.sourcePort;
+    stream.sessionUID = header.m_sessionUID;
+    bump(stats_.sessions);
+    shard.lastStream = slot;
+    return stream;
+}
+
+SequenceVerdict SequenceTracker::observe(const PacketTypeInfo& info, const PacketHeader& header,
+                                         const ReceiveInfo& received) {
+    Stream& stream = streamFor(shards_[shardOf(header, received)], header, received);
+    stream.lastSeenNs = received.monoNs;
+    bump(stats_.types[info.id].received);
+
+    const uint32_t overall = header.m_overallFrameIdentifier;
+    if (!stream.haveNewest || overall > stream.newestOverall) {
+        if (stream.haveNewest && header.m_frameIdentifier < stream.newestFrame) {
+            FlashbackEvent event = {stream.sessionUID, stream.sourceAddress, stream.sourcePort,
+                                    stream.newestFrame, header.m_frameIdentifier, overall,
+                                    stream.newestSessionTime, header.m_sessionTime};
+            bump(stats_.flashbacks);
+            stats_.lastFlashbackFrom.store(event.fromFrame, std::memory_order_relaxed);
+            stats_.lastFlashbackTo.store(event.toFrame, std::memory_order_relaxed);
+            std::cout << "Flashback: frame " << event.fromFrame << " -> " << event.toFrame
+                      << " (session time " << event.fromSessionTime << " s -> " << event.toSessionTime << " s)\n";
+            for (const FlashbackHandler& handler : handlers_) {
+                handler(event);
+            }
+        }
+        stream.haveNewest = true;
+        stream.newestOverall = overall;
+        stream.newestFrame = header.m_frameIdentifier;
+        stream.newestSessionTime = header.m_sessionTime;
+    }
+
+    TypeState& type = stream.types[info.id];
+    if (!type.seen) {
+        type.seen = true;
+        type.lastOverall = overall;
+        return SequenceVerdict::InOrder;
+    }
+    if (overall < type.lastOverall) {
+        bump(stats_.types[info.id].outOfOrder);
+        return SequenceVerdict::OutOfOrder;
+    }
+    if (!info.oncePerFrame) {
+        type.lastOverall = overall;
+        return SequenceVerdict::InOrder;
+    }
+    if (overall == type.lastOverall) {
+        bump(stats_.types[info.id].duplicates);
+        return SequenceVerdict::Duplicate;
+    }
+
+    const float delta = static_cast<float>(overall - type.lastOverall);
+    type.lastOverall = overall;
+    if (type.stride == 0.0f) {
+        type.stride = delta;
+    } else if (delta > 2.0f * type.stride) {
+        type.largeMin = type.largeSteps ? std::min(type.largeMin, delta) : delta;
+        type.pendingGaps += static_cast<uint64_t>(std::lround(delta / type.stride)) - 1;
+        if (++type.largeSteps >= kStrideResetSteps) {
+            // Every step is this long now: the stride changed, nothing was lost
+            type.stride = type.largeMin;
+            type.largeSteps = 0;
+            type.pendingGaps = 0;
+        }
+    } else {
+        if (type.pendingGaps) bump(stats_.types[info.id].gaps, type.pendingGaps);
+        type.largeSteps = 0;
+        type.pendingGaps = 0;
+        type.stride += (delta - type.stride) / 8.0f;
+    }
+    return SequenceVerdict::InOrder;
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "packetStructs.hpp"
+#include "packetDispatch.hpp"
+#include "packetQueue.hpp"
+
+// The game rewound: frames after toFrame were replayed from an earlier point, so any
+// data stamped after toSessionTime is stale
+struct FlashbackEvent {
+    uint64_t sessionUID;
+    uint32_t sourceAddress;    // sender of the stream that rewound (network byte order)
+    uint16_t sourcePort;
+    uint32_t fromFrame;        // newest frame before the flashback
+    uint32_t toFrame;          // frame play resumed from
+    uint32_t overallFrame;     // overall frame of the first packet after it
+    float fromSessionTime;
+    float toSessionTime;
+};
+
+// Per packet type - written by the ingest thread only, readable from any thread
+struct SequenceTypeStats {
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> gaps{0};         // frames estimated lost (once-per-frame types only)
+    std::atomic<uint64_t> duplicates{0};   // same overall frame again; not published
+    std::atomic<uint64_t> outOfOrder{0};   // older overall frame than the newest seen
+};
+
+struct SequenceStats {
+    SequenceTypeStats types[kNumPacketTypes];
+    std::atomic<uint64_t> flashbacks{0};
+    std::atomic<uint64_t> sessions{0};     // streams started: new (sender, session UID) pairs
+    std::atomic<uint64_t> streamsEvicted{0};   // idle streams dropped to make room for a new one
+    std::atomic<uint32_t> lastFlashbackFrom{0};
+    std::atomic<uint32_t> lastFlashbackTo{0};
+};
+
+enum class SequenceVerdict : uint8_t {
+    InOrder,
+    Duplicate,
+    OutOfOrder
+};
+
+// Classifies every validated packet by m_overallFrameIdentifier, which never goes back,
+// and spots flashbacks as m_frameIdentifier going back while it advances. A few compares
+// and counter stores per packet.
+//
+// Gaps are estimated per type from a running average of the frame stride between
+// consecutive packets (the stride depends on the game's send rate and frame rate); a
+// step of more than twice the stride counts the frames in between as lost. The count is
+// held until a normal step follows: kStrideResetSteps large steps in a row mean the
+// stride itself changed (frame rate drop, new send rate, a relay forwarding every Nth
+// frame), so the smallest of them becomes the stride and nothing is counted.
+//
+// Frame identifiers are only comparable within one stream, so state is kept per sender
+// address and session UID: two rigs on the network, or one rig restarting a session,
+// never read as flashbacks or losses of each other. Counters are shared by all streams.
+//
+// Stream state is split into kShards shards by shardOf(); a stream always lands in the
+// same one. Listener threads publishing different streams observe in parallel, each
+// holding the publish lock of its stream's shard (see handleDatagram()).
+class SequenceTracker {
+public:
+    using FlashbackHandler = std::function<void(const FlashbackEvent&)>;
+
+    // Register before ingest starts. Handlers run on the ingest thread, before the
+    // first packet after the flashback is published.
+    void onFlashback(FlashbackHandler handler);
+
+    // Ingest threads; calls for one shard must not overlap
+    SequenceVerdict observe(const PacketTypeInfo& info, const PacketHeader& header,
+                            const ReceiveInfo& received);
+
+    const SequenceStats& stats() const { return stats_; }
+
+    static constexpr size_t kShards = 16;
+    static constexpr size_t kMaxStreams = 8;   // per shard
+    static constexpr uint8_t kStrideResetSteps = 8;
+
+    // Shard of a stream, from its sender address and session UID
+    static size_t shardOf(const PacketHeader& header, const ReceiveInfo& received) {
+        uint64_t h = header.m_sessionUID ^ (static_cast<uint64_t>(received.sourceAddress) * 0x9E3779B97F4A7C15ull);
+        return static_cast<size_t>((h ^ (h >> 29) ^ (h >> 47)) % kShards);
+    }
+
+private:
+    struct TypeState {
+        bool seen;
+        uint32_t lastOverall;
+        float stride;          // average overall-frame step between packets of this type
+        uint8_t largeSteps;    // consecutive steps of more than twice the stride
+        float largeMin;        // smallest of them
+        uint64_t pendingGaps;  // frames they would lose, counted once a normal step follows
+    };
+
+    struct Stream {
+        bool active;
+        uint32_t sourceAddress;
+        uint16_t sourcePort;
+        uint64_t sessionUID;
+        uint64_t lastSeenNs;   // steady clock, picks the stream to evict when the table is full
+
+        // Newest packet of any type, for flashback detection
+        bool haveNewest;
+        uint32_t newestOverall;
+        uint32_t newestFrame;
+        float newestSessionTime;
+
+        TypeState types[kNumPacketTypes];
+
+        bool matches(const PacketHeader& header, const ReceiveInfo& received) const {
+            return active && sessionUID == header.m_sessionUID &&
+                   sourceAddress == received.sourceAddress && sourcePort == received.sourcePort;
+        }
+    };
+
+    struct Shard {
+        Stream streams[kMaxStreams];
+        size_t lastStream;   // a datagram almost always belongs to the same stream as the last
+    };
+
+    Stream& streamFor(Shard& shard, const PacketHeader& header, const ReceiveInfo& received);
+
+    // Shards on other threads bump the same counters
+    static void bump(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    Shard shards_[kShards] = {};
+    std::vector<FlashbackHandler> handlers_;
+    SequenceStats stats_;
+};
+
+extern SequenceTracker g_sequenceTracker;
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <arpa/inet.h>
+#include "packetStructs.hpp"
+#include "packetQueue.hpp"
+
+// One game session as seen from one machine. The session UID alone is not enough: every
+// rig in an online lobby can report the same m_sessionUID, so the sender's IP is part of
+// the key. Replayed packets have no sender and key on the UID alone.
+struct SessionKey {
+    uint32_t sourceAddress;   // IPv4, network byte order; 0 for replay
+    uint64_t sessionUID;
+
+    static SessionKey of(const PacketHeader& header, const ReceiveInfo& received) {
+        return {received.sourceAddress, header.m_sessionUID};
+    }
+
+    bool operator==(const SessionKey& other) const {
+        return sourceAddress == other.sourceAddress && sessionUID == other.sessionUID;
+    }
+    bool operator!=(const SessionKey& other) const { return !(*this == other); }
+    bool operator<(const SessionKey& other) const {
+        return sourceAddress != other.sourceAddress ? sourceAddress < other.sourceAddress
+                                                    : sessionUID < other.sessionUID;
+    }
+};
+
+// "192.168.1.20" (or "replay"), for labels and file names
+inline std::string sessionSourceName(const SessionKey& key) {
+    if (key.sourceAddress == 0) return "replay";
+    char text[INET_ADDRSTRLEN];
+    in_addr addr;
+    addr.s_addr = key.sourceAddress;
+    return inet_ntop(AF_INET, &addr, text, sizeof(text)) ? text : "unknown";
+}
+
+// "192.168.1.20 5eed5eed5eed5eed"
+inline std::string describeSession(const SessionKey& key) {
+    char uid[17];
+    std::snprintf(uid, sizeof(uid), "%016llx", (unsigned long long)key.sessionUID);
+    return sessionSourceName(key) + " " + uid;
+}
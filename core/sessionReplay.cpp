@@ -0,0 +1,88 @@
+#include "sessionReplay.hpp"
+#include "captureFile.hpp"
+#include "packetStructs.hpp"
+#include "udpListener.hpp"
+#include "latencyHistogram.hpp"
+#include <iostream>
+#include <chrono>
+#include <thread>
+
+static ReplayStats g_replayStats;
+
+const ReplayStats& getReplayStats() {
+    return g_replayStats;
+}
+
+bool runSessionReplay(const ReplayConfig& config) {
+    using clock = std::chrono::steady_clock;
+
+    CaptureReader reader;
+    if (!reader.open(config.path)) {
+        g_replayStats.finished.store(true);
+        return false;
+    }
+
+    std::cout << "Replaying " << config.path << " (session " << std::hex << reader.header().sessionUID
+              << std::dec << ") at ";
+    if (config.speed > 0.0) std::cout << config.speed << "x\n";
+    else std::cout << "max speed\n";
+
+    CaptureRecord record;
+    auto wallStart = clock::now();
+
+    do {
+        // Session time is re-anchored at the start of each pass and whenever it jumps
+        // backwards (flashback, session restart) or stalls for longer than maxGapSeconds.
+        bool anchored = false;
+        double anchorSessionTime = 0.0;
+        double replayTime = 0.0;     // seconds of original session time replayed so far
+        double lastSessionTime = 0.0;
+        wallStart = clock::now();
+
+        while (reader.next(record)) {
+            const PacketHeader* header = reinterpret_cast<const PacketHeader*>(record.data);
+            double sessionTime = header->m_sessionTime;
+
+            if (config.speed > 0.0) {
+                if (!anchored) {
+                    anchored = true;
+                    anchorSessionTime = sessionTime;
+                    lastSessionTime = sessionTime;
+                }
+
+                double delta = sessionTime - lastSessionTime;
+                if (delta < 0.0 || delta > config.maxGapSeconds) {
+                    // Keep the replay clock monotonic across discontinuities
+                    double step = delta < 0.0 ? 0.0 : config.maxGapSeconds;
+                    anchorSessionTime = sessionTime - (replayTime + step);
+                }
+                replayTime = sessionTime - anchorSessionTime;
+                lastSessionTime = sessionTime;
+
+                auto due = wallStart + std::chrono::duration_cast<clock::duration>(
+                    std::chrono::duration<double>(replayTime / config.speed));
+                if (due > clock::now()) {
+                    std::this_thread::sleep_until(due);
+                }
+            }
+
+            // Original wall time for the record, but latency is measured from now
+            handleDatagram(record.data, record.size, {record.receivedNs, monotonicNowNs()});
+            g_replayStats.packets.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        g_replayStats.passes.fetch_add(1, std::memory_order_relaxed);
+        reader.rewind();
+    } while (config.loop);
+
+    double elapsed = std::chrono::duration<double>(clock::now() - wallStart).count();
+    std::cout << "Replay finished: " << g_replayStats.packets.load() << " packets, last pass "
+              << elapsed << " s";
+    if (reader.resyncs() > 0) {
+        std::cout << " (" << reader.resyncs() << " corrupt regions skipped)";
+    }
+    std::cout << "\n";
+
+    g_replayStats.finished.store(true);
+    return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+struct ReplayConfig {
+    std::string path;          // .f1cap capture to replay
+    double speed = 1.0;        // 1 = real time, N = N x faster, 0 = as fast as possible
+    bool loop = false;         // start over at end of file
+    double maxGapSeconds = 5.0; // longer m_sessionTime gaps (menus, pauses) are shortened to this
+};
+
+struct ReplayStats {
+    std::atomic<uint64_t> packets{0};
+    std::atomic<uint64_t> passes{0};      // completed passes over the file
+    std::atomic<bool> finished{false};
+};
+
+// Feed a recorded session through handleDatagram(), the same dispatch path the UDP
+// listener uses, paced by the original m_sessionTime spacing. Blocks until done;
+// run it on its own thread in place of startUDPListener().
+bool runSessionReplay(const ReplayConfig& config);
+
+const ReplayStats& getReplayStats();
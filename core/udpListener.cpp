@@ -1,204 +1,424 @@
 #include <iostream>
 #include <cstring>
+#include <cerrno>
+#include <algorithm>
 #include <arpa/inet.h>
 #include <unistd.h>
-#include <fstream>
-#include <sstream>
-#include <chrono>
-#include <iomanip>
-#include <sys/stat.h>
-#include <dirent.h>
-#include <map>
-#include <memory>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/time.h>
 #include "packetStructs.hpp"
-#include "packetWriters.hpp"
-// ===================== PACKET IDS =====================
-
-enum PacketID : uint8_t {
-    MOTION = 0,                    // Contains all motion data for player's car
-    SESSION = 1,                   // Data about the session – track, time left
-    LAP_DATA = 2,                  // Data about all the lap times of cars in the session
-    EVENT = 3,                     // Various notable events that happen during a session
-    PARTICIPANTS = 4,              // List of participants in the session
-    CAR_SETUPS = 5,                // Packet detailing car setups for cars in the race
-    CAR_TELEMETRY = 6,             // Telemetry data for all cars
-    CAR_STATUS = 7,                // Status data for all cars
-    FINAL_CLASSIFICATION = 8,      // Final classification confirmation at the end of a race
-    LOBBY_INFO = 9,                // Information about players in a multiplayer lobby
-    CAR_DAMAGE = 10,               // Damage status for all cars
-    SESSION_HISTORY = 11,          // Lap and tyre data for session
-    TYRE_SETS = 12,                // Extended tyre set data
-    MOTION_EX = 13                 // Extended motion data for player car
+#include "packetDispatch.hpp"
+#include "udpListener.hpp"
+#include "packetBus.hpp"
+#include "latencyHistogram.hpp"
+#include "sequenceTracker.hpp"
+#include "ioUring.hpp"
+#include <chrono>
+
+static UDPListenerStats g_listenerStats;
+
+// Each stream's sequence state and session stores have one writer at a time: packets of a
+// stream (sender address + session UID) always take the lock of its sequence tracker shard.
+// Listeners receiving different rigs publish in parallel; what all streams share (the
+// packet log queue, relay rate limits, counters) is safe for several publishers. With a
+// single listener (or replay) no lock is ever contended.
+struct alignas(64) PublishShard {
+    std::mutex mutex;
 };
+static PublishShard g_publishShards[SequenceTracker::kShards];
 
-// Helper function to get packet type name
-std::string getPacketTypeName(uint8_t packetId) {
-    switch (packetId) {
-        case MOTION: return "motion";
-        case SESSION: return "session";
-        case LAP_DATA: return "lap_data";
-        case EVENT: return "event";
-        case PARTICIPANTS: return "participants";
-        case CAR_SETUPS: return "car_setups";
-        case CAR_TELEMETRY: return "car_telemetry";
-        case CAR_STATUS: return "car_status";
-        case FINAL_CLASSIFICATION: return "final_classification";
-        case LOBBY_INFO: return "lobby_info";
-        case CAR_DAMAGE: return "car_damage";
-        case SESSION_HISTORY: return "session_history";
-        case TYRE_SETS: return "tyre_sets";
-        case MOTION_EX: return "motion_ex";
-        default: return "unknown";
-    }
+const UDPListenerStats& getUDPListenerStats() {
+    return g_listenerStats;
 }
 
-// Global file handle cache
-std::map<uint8_t, std::shared_ptr<std::ofstream>> fileCache;
-
-// Helper function to get or create cached file handle
-std::ofstream& getCachedFileHandle(uint8_t packetId) {
-    if (fileCache.find(packetId) == fileCache.end()) {
-        // Create telemetry directory if it doesn't exist
-        struct stat st;
-        if (stat("telemetry_data", &st) != 0) {
-            mkdir("telemetry_data", 0755);
+// Validate a received datagram and publish it to every subscriber of its type
+void handleDatagram(const uint8_t* data, size_t bytes, const ReceiveInfo& received) {
+    PacketReject reason;
+    const PacketTypeInfo* info = validatePacket(data, bytes, &reason);
+    if (!info) {
+        // Report the first few rejects, then just count them
+        if (g_listenerStats.rejected.fetch_add(1, std::memory_order_relaxed) < 10) {
+            std::cerr << "Rejected packet (" << bytes << " bytes): " << packetRejectName(reason) << "\n";
         }
+        return;
+    }
 
-        std::stringstream filename;
-        filename << "telemetry_data/" << getPacketTypeName(packetId) << ".txt";
-
-        auto filePtr = std::make_shared<std::ofstream>(filename.str(), std::ios::app);
-        if (!filePtr->is_open()) {
-            std::cerr << "Warning: Unable to open file: " << filename.str() << "\n";
-        }
-        fileCache[packetId] = filePtr;
+    // Counted, and a flashback announced, before anyone sees the packet. A re-delivered
+    // frame would only be pushed into the live rings twice, so it stops here.
+    const PacketHeader* header = reinterpret_cast<const PacketHeader*>(data);
+    std::lock_guard<std::mutex> lock(g_publishShards[SequenceTracker::shardOf(*header, received)].mutex);
+    if (g_sequenceTracker.observe(*info, *header, received) == SequenceVerdict::Duplicate) {
+        return;
     }
 
-    return *fileCache[packetId];
+    uint64_t now = monotonicNowNs();
+    g_latency[LATENCY_DECODE].record(now > received.monoNs ? now - received.monoNs : 0);
+
+    g_packetBus.publish(*info, data, bytes, received);
 }
 
-void callPacketTypeWriter(const uint8_t* data, std::ofstream& file, uint8_t packetId) {
-    // If this is a car telemetry packet, parse the telemetry entries into readable text
-    if (packetId == CAR_TELEMETRY) {
-        writeCarTelemetryPacket(data, file);
-    } else if (packetId == MOTION) {
-        writeMotionPacket(data, file);
-    } else if (packetId == SESSION) {
-        writeSessionPacket(data, file);
-    } else if (packetId == LAP_DATA) {
-        writeLapDataPacket(data, file);
-    } else if (packetId == EVENT) {
-        writeEventPacket(data, file);
-    } else if (packetId == PARTICIPANTS) {
-        writeParticipantsPacket(data, file);
-    } else if (packetId == CAR_SETUPS) {
-        writeCarSetupsPacket(data, file);
-    } else if (packetId == CAR_STATUS) {
-        writeCarStatusPacket(data, file);
-    } else if (packetId == FINAL_CLASSIFICATION) {
-        writeFinalClassificationPacket(data, file);
-    } else if (packetId == LOBBY_INFO) {
-        writeLobbyInfoPacket(data, file);
-    } else if (packetId == CAR_DAMAGE) {
-        writeCarDamagePacket(data, file);
-    } else if (packetId == SESSION_HISTORY) {
-        writeSessionHistoryPacket(data, file);
-    } else if (packetId == TYRE_SETS) {
-        writeTyreSetsPacket(data, file);
-    } else if (packetId == MOTION_EX) {
-        writeMotionExPacket(data, file);
-    } else {
-        file << "Unknown packet type: " << static_cast<int>(packetId);
-    }
-    file << "\n";
+static uint64_t systemNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
-// Helper function to write packet to file
-void writePacketToFile(uint8_t packetId, const uint8_t* data, size_t size) {
-    try {
-        if (size < sizeof(PacketHeader)) {
-            std::cerr << "Packet too small to contain header (" << size << " bytes)\n";
-            return;
-        }
+// Kernel receive timestamps: nanosecond SO_TIMESTAMPNS where available (Linux), the
+// microsecond SO_TIMESTAMP otherwise (macOS). Both are CLOCK_REALTIME.
+#ifdef SO_TIMESTAMPNS
+static constexpr int kTimestampOption = SO_TIMESTAMPNS;
+static constexpr int kTimestampCmsg = SCM_TIMESTAMPNS;
+using KernelTimestamp = timespec;
+static uint64_t toNs(const timespec& ts) { return ts.tv_sec * 1000000000ull + ts.tv_nsec; }
+#else
+static constexpr int kTimestampOption = SO_TIMESTAMP;
+static constexpr int kTimestampCmsg = SCM_TIMESTAMP;
+using KernelTimestamp = timeval;
+static uint64_t toNs(const timeval& tv) { return tv.tv_sec * 1000000000ull + tv.tv_usec * 1000ull; }
+#endif
 
-        std::ofstream& file = getCachedFileHandle(packetId);
-        if (!file.is_open()) {
-            return;
-        }
+static constexpr size_t kControlSize = CMSG_SPACE(sizeof(KernelTimestamp));
 
-        // timestamp
-        auto now = std::chrono::system_clock::now();
-        auto t = std::chrono::system_clock::to_time_t(now);
-        file << "==== " << std::put_time(std::localtime(&t), "%Y-%m-%d %H:%M:%S") << " ====\n";
+// Wall-clock kernel timestamp of a received message, or 0 if it carried none
+static uint64_t kernelTimestampNs(msghdr& hdr) {
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == kTimestampCmsg) {
+            KernelTimestamp ts;
+            std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            return toNs(ts);
+        }
+    }
+    return 0;
+}
 
-        callPacketTypeWriter(data, file, packetId);
+// Receive time and sender of one datagram. The kernel stamp is moved onto steady_clock by
+// the wall/steady offset sampled once per batch, so time spent queued in the socket counts.
+static ReceiveInfo receiveInfo(uint64_t kernelNs, uint64_t wallNow, uint64_t monoNow, const sockaddr_in& from) {
+    ReceiveInfo info = {wallNow, monoNow};
+    if (kernelNs != 0 && kernelNs <= wallNow) {
+        uint64_t queued = wallNow - kernelNs;
+        info = {kernelNs, monoNow > queued ? monoNow - queued : 0};
+    }
+    info.sourceAddress = from.sin_addr.s_addr;
+    info.sourcePort = from.sin_port;
+    return info;
+}
 
-        file.flush();  // Flush to disk but keep file open
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Error writing packet file: " << e.what() << "\n";
+static void recordBatch(unsigned listener, size_t syscalls, size_t count, size_t bytes, size_t stamped = 0) {
+    g_listenerStats.syscalls.fetch_add(syscalls, std::memory_order_relaxed);
+    if (count == 0) return;
+    g_listenerStats.packets.fetch_add(count, std::memory_order_relaxed);
+    g_listenerStats.perListener[listener].fetch_add(count, std::memory_order_relaxed);
+    g_listenerStats.kernelStamped.fetch_add(stamped, std::memory_order_relaxed);
+    g_listenerStats.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    uint64_t maxBatch = g_listenerStats.maxBatch.load(std::memory_order_relaxed);
+    while (count > maxBatch &&
+           !g_listenerStats.maxBatch.compare_exchange_weak(maxBatch, count, std::memory_order_relaxed)) {
     }
 }
 
-// UDP listener thread function - call from main to start listening
-void startUDPListener() {
+static constexpr size_t kPacketSlotSize = PacketSlot::kMaxSize;
+
+// Socket bound to `addr`, or -1. Several listeners share the address through SO_REUSEPORT.
+static int openSocket(const UDPListenerConfig& config, const sockaddr_in& addr) {
     int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 
     if (sock < 0) {
         std::cerr << "Failed to create socket\n";
-        return;
+        return -1;
     }
 
-    sockaddr_in addr = {};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(20777);
-    addr.sin_addr.s_addr = INADDR_ANY;  // listen on all interfaces
+    int on = 1;
+    if (config.listeners > 1 && setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0) {
+        std::cerr << "Failed to set SO_REUSEPORT\n";
+        close(sock);
+        return -1;
+    }
 
     if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        std::cerr << "Failed to bind socket\n";
+        std::cerr << "Failed to bind socket to " << config.bindAddress << ":" << config.port << "\n";
         close(sock);
-        return;
+        return -1;
     }
 
-    // Clear all text files in telemetry_data directory if it exists
-    DIR* dir = opendir("telemetry_data");
-    if (dir != nullptr) {
-        struct dirent* entry;
-        while ((entry = readdir(dir)) != nullptr) {
-            if (entry->d_type == DT_REG && std::string(entry->d_name).find(".txt") != std::string::npos) {
-                std::string filepath = "telemetry_data/" + std::string(entry->d_name);
-                remove(filepath.c_str());
-            }
+    if (config.recvTimeoutMs > 0) {
+        timeval tv = {};
+        tv.tv_sec = config.recvTimeoutMs / 1000;
+        tv.tv_usec = (config.recvTimeoutMs % 1000) * 1000;
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+
+    if (setsockopt(sock, SOL_SOCKET, kTimestampOption, &on, sizeof(on)) < 0) {
+        std::cerr << "Kernel receive timestamps unavailable, stamping in user space\n";
+    }
+    return sock;
+}
+
+// Keep listener `index` on one core so its socket buffers and receive state stay in that
+// core's cache. macOS has no hard affinity, so the scheduler decides there.
+static void pinToCore(unsigned index) {
+#ifdef __linux__
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores == 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cores, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        std::cerr << "Failed to pin listener " << index << " to core " << index % cores << "\n";
+    }
+#else
+    (void)index;
+#endif
+}
+
+// Receive loop of one listener. Everything it touches before handleDatagram() - the slab,
+// message headers, control buffers and receive times - belongs to this thread alone.
+static void receiveLoop(int sock, unsigned listener, unsigned batchSize) {
+    // Pre-allocated slab of packet slots, one per datagram in a batch
+    std::vector<uint8_t> slab(batchSize * kPacketSlotSize);
+
+#ifdef __linux__
+    std::vector<mmsghdr> msgs(batchSize);
+    std::vector<iovec> iovecs(batchSize);
+    std::vector<sockaddr_in> senders(batchSize);
+    std::vector<uint8_t> control(batchSize * kControlSize);
+    std::vector<ReceiveInfo> times(batchSize);
+    for (unsigned i = 0; i < batchSize; ++i) {
+        iovecs[i].iov_base = slab.data() + i * kPacketSlotSize;
+        iovecs[i].iov_len = kPacketSlotSize;
+        msgs[i] = {};
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &senders[i];
+        msgs[i].msg_hdr.msg_control = control.data() + i * kControlSize;
+    }
+
+    while (true) {
+        // The kernel shrinks msg_controllen and msg_namelen to what it wrote
+        for (unsigned i = 0; i < batchSize; ++i) {
+            msgs[i].msg_hdr.msg_controllen = kControlSize;
+            msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        }
+
+        // MSG_WAITFORONE: block for the first datagram, then take whatever else is queued
+        int n = recvmmsg(sock, msgs.data(), batchSize, MSG_WAITFORONE, nullptr);
+        if (n <= 0) {
+            recordBatch(listener, 1, 0, 0);
+            continue;
+        }
+
+        uint64_t wallNow = systemNowNs();
+        uint64_t monoNow = monotonicNowNs();
+        size_t batchBytes = 0;
+        size_t stamped = 0;
+        for (int i = 0; i < n; ++i) {
+            batchBytes += msgs[i].msg_len;
+            uint64_t kernelNs = kernelTimestampNs(msgs[i].msg_hdr);
+            if (kernelNs) ++stamped;
+            times[i] = receiveInfo(kernelNs, wallNow, monoNow, senders[i]);
+        }
+        recordBatch(listener, 1, n, batchBytes, stamped);
+
+        for (int i = 0; i < n; ++i) {
+            handleDatagram(slab.data() + i * kPacketSlotSize, msgs[i].msg_len, times[i]);
         }
-        closedir(dir);
     }
+#else
+    // No recvmmsg: block for the first datagram, then drain the socket without waiting
+    std::vector<size_t> lengths(batchSize);
+    std::vector<uint64_t> kernelNs(batchSize);
+    std::vector<sockaddr_in> senders(batchSize);
+    std::vector<ReceiveInfo> times(batchSize);
+    alignas(cmsghdr) uint8_t control[kControlSize];
 
-    std::cout << "UDP Listener: Listening on port 20777...\n";
-    std::cout << "Waiting for F1 telemetry packets...\n\n";
+    while (true) {
+        unsigned n = 0;
+        size_t calls = 0;
+        size_t batchBytes = 0;
+        size_t stamped = 0;
+        while (n < batchSize) {
+            iovec iov = {slab.data() + n * kPacketSlotSize, kPacketSlotSize};
+            msghdr hdr = {};
+            hdr.msg_iov = &iov;
+            hdr.msg_iovlen = 1;
+            hdr.msg_name = &senders[n];
+            hdr.msg_namelen = sizeof(sockaddr_in);
+            hdr.msg_control = control;
+            hdr.msg_controllen = sizeof(control);
+
+            ssize_t bytes = recvmsg(sock, &hdr, n == 0 ? 0 : MSG_DONTWAIT);
+            ++calls;
+            if (bytes <= 0) break;
+            kernelNs[n] = kernelTimestampNs(hdr);
+            if (kernelNs[n]) ++stamped;
+            lengths[n++] = static_cast<size_t>(bytes);
+            batchBytes += static_cast<size_t>(bytes);
+        }
+        recordBatch(listener, calls, n, batchBytes, stamped);
+
+        uint64_t wallNow = systemNowNs();
+        uint64_t monoNow = monotonicNowNs();
+        for (unsigned i = 0; i < n; ++i) {
+            times[i] = receiveInfo(kernelNs[i], wallNow, monoNow, senders[i]);
+        }
+        for (unsigned i = 0; i < n; ++i) {
+            handleDatagram(slab.data() + i * kPacketSlotSize, lengths[i], times[i]);
+        }
+    }
+#endif
+}
+
+#ifdef __linux__
+// io_uring receive loop. One multishot recvmsg stays armed and the kernel completes it
+// into provided buffers, one datagram each, so a burst costs one io_uring_enter however
+// many datagrams it holds. Datagrams are handled in place, then their buffers go back.
+// Returns false if the ring can't be set up here; the caller falls back to receiveLoop().
+static bool uringReceiveLoop(int sock, unsigned listener, const UDPListenerConfig& config) {
+    // Up to 8 batches in flight: the buffers only come back once a batch is handled
+    unsigned bufferCount = 1;
+    while (bufferCount < config.batchSize * 8 && bufferCount < 4096) bufferCount <<= 1;
+
+    IoUring ring;
+    if (!ring.init(64)) return false;
+
+    msghdr layout = {};
+    layout.msg_namelen = sizeof(sockaddr_in);
+    layout.msg_controllen = kControlSize;
+    const size_t bufferSize = (IoUring::recvBufferSize(layout, kPacketSlotSize) + 63) & ~size_t(63);
+    std::vector<uint8_t> buffers(bufferCount * bufferSize);
+    if (!ring.registerBuffers(0, buffers.data(), bufferCount, static_cast<unsigned>(bufferSize))) {
+        return false;
+    }
 
-    uint8_t buffer[2048];
+    std::vector<UringCompletion> done(bufferCount);
+    std::vector<uint8_t*> payloads(bufferCount);
+    std::vector<size_t> lengths(bufferCount);
+    std::vector<ReceiveInfo> times(bufferCount);
+    std::vector<uint16_t> used(bufferCount);
+    const uint64_t kRecv = 1;
+    bool armed = ring.queueRecvMsgMultishot(sock, &layout, 0, kRecv);
+    bool receivedAny = false;
 
     while (true) {
-        ssize_t bytes = recv(sock, buffer, sizeof(buffer), 0);
+        if (!ring.submit(1, config.recvTimeoutMs)) {
+            std::cerr << "io_uring receive failed on listener " << listener << "\n";
+            return false;   // the socket is untouched: the caller carries on with recvmmsg
+        }
+        size_t completions = ring.reap(done.data(), done.size());
 
-        if (bytes <= 0) continue;
+        uint64_t wallNow = systemNowNs();
+        uint64_t monoNow = monotonicNowNs();
+        size_t n = 0, nUsed = 0, batchBytes = 0, stamped = 0;
+        for (size_t i = 0; i < completions; ++i) {
+            const UringCompletion& c = done[i];
+            if (!IoUring::hasMore(c)) armed = false;
+            if (c.result < 0) {
+                if (c.result == -ENOBUFS) {
+                    // Datagrams wait in the socket until buffers are handed back below
+                    g_listenerStats.bufferStalls.fetch_add(1, std::memory_order_relaxed);
+                } else if (!receivedAny) {
+                    return false;   // e.g. EINVAL: kernel without multishot recvmsg
+                }
+                continue;
+            }
+            if (!IoUring::hasBuffer(c)) continue;
 
-        if (bytes < sizeof(PacketHeader)) {
-            std::cerr << "Packet too small to contain header\n";
-            continue;
+            uint16_t id = IoUring::bufferId(c);
+            used[nUsed++] = id;
+            msghdr hdr;
+            uint8_t* payload;
+            size_t length;
+            if (!IoUring::splitRecvMsg(buffers.data() + id * bufferSize, layout, hdr, &payload, &length)) {
+                continue;   // larger than any F1 packet
+            }
+            sockaddr_in from = {};
+            std::memcpy(&from, hdr.msg_name, std::min<size_t>(hdr.msg_namelen, sizeof(from)));
+            uint64_t kernelNs = kernelTimestampNs(hdr);
+            if (kernelNs) ++stamped;
+            payloads[n] = payload;
+            lengths[n] = length;
+            times[n++] = receiveInfo(kernelNs, wallNow, monoNow, from);
+            batchBytes += length;
         }
+        recordBatch(listener, 1, n, batchBytes, stamped);
+        if (n) receivedAny = true;
 
-        PacketHeader* header = reinterpret_cast<PacketHeader*>(buffer);
+        for (size_t i = 0; i < n; ++i) {
+            handleDatagram(payloads[i], lengths[i], times[i]);
+        }
+        for (size_t i = 0; i < nUsed; ++i) ring.recycleBuffer(used[i]);
+        ring.publishBuffers();
 
-        // Verify packet format (should be 2023)
-        if (header->m_packetFormat != 2023) {
-            std::cerr << "Invalid packet format: " << header->m_packetFormat << "\n";
-            continue;
+        // Multishot ends when the buffers ran out (or on error): re-arm, sent with the next wait
+        if (!armed) armed = ring.queueRecvMsgMultishot(sock, &layout, 0, kRecv);
+    }
+}
+#endif
+
+// One listener's thread: io_uring when asked for and available, recvmmsg otherwise
+static void runListener(int sock, unsigned listener, const UDPListenerConfig& config) {
+#ifdef __linux__
+    if (config.ioUring) {
+        g_listenerStats.uringListeners.fetch_add(1, std::memory_order_relaxed);
+        if (uringReceiveLoop(sock, listener, config)) return;
+        g_listenerStats.uringListeners.fetch_sub(1, std::memory_order_relaxed);
+        std::cerr << "Listener " << listener << ": io_uring unavailable, using recvmmsg\n";
+    }
+#endif
+    receiveLoop(sock, listener, config.batchSize);
+}
+
+void startUDPListener() {
+    startUDPListener(UDPListenerConfig{});
+}
+
+// UDP listener thread function - call from main to start listening
+void startUDPListener(UDPListenerConfig config) {
+    if (config.batchSize == 0) config.batchSize = 1;
+    if (config.listeners == 0) config.listeners = 1;
+    if (config.listeners > kMaxListeners) config.listeners = kMaxListeners;
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config.port);
+    if (inet_pton(AF_INET, config.bindAddress.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "Invalid bind address: " << config.bindAddress << "\n";
+        return;
+    }
+
+    std::vector<int> sockets;
+    for (unsigned i = 0; i < config.listeners; ++i) {
+        int sock = openSocket(config, addr);
+        if (sock < 0) {
+            for (int open : sockets) close(open);
+            return;
         }
+        sockets.push_back(sock);
+    }
+    g_listenerStats.listeners.store(sockets.size(), std::memory_order_relaxed);
 
-        // Get packet type name and write to file
-        writePacketToFile(header->m_packetId, buffer, bytes);
+    std::cout << "UDP Listener: Listening on " << config.bindAddress << ":" << config.port << " ("
+              << sockets.size() << (sockets.size() == 1 ? " socket" : " sockets") << ", batch size "
+              << config.batchSize << ")...\n";
+    std::cout << "Waiting for F1 telemetry packets...\n\n";
+
+    if (sockets.size() == 1) {
+        runListener(sockets[0], 0, config);
+    } else {
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < sockets.size(); ++i) {
+            threads.emplace_back([&config, &sockets, i]() {
+                if (config.pinThreads) pinToCore(i);
+                runListener(sockets[i], i, config);
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
     }
 
-    close(sock);
+    for (int sock : sockets) close(sock);
 }
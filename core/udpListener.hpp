@@ -1,4 +1,51 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "packetQueue.hpp"
 
-// Start UDP listener in background thread
+constexpr unsigned kMaxListeners = 16;
+
+// Receive-side tuning for the UDP listener
+struct UDPListenerConfig {
+    unsigned batchSize = 32;   // max datagrams pulled per receive syscall (recvmmsg on Linux)
+    int recvTimeoutMs = 100;   // how long one receive call may block waiting for the first datagram
+    std::string bindAddress = "0.0.0.0";   // IPv4 interface address; 0.0.0.0 listens on all of them
+    uint16_t port = 20777;
+    unsigned listeners = 1;    // SO_REUSEPORT sockets, each with its own receive thread (max kMaxListeners)
+    bool pinThreads = true;    // pin listener thread i to core i (Linux only)
+    bool ioUring = false;      // Linux 6.0+: multishot recvmsg into provided buffers; recvmmsg otherwise
+};
+
+// Ingest counters - written by the listener threads, readable from any thread
+struct UDPListenerStats {
+    std::atomic<uint64_t> syscalls{0};   // receive syscalls issued (including timeouts)
+    std::atomic<uint64_t> packets{0};    // datagrams received
+    std::atomic<uint64_t> bytes{0};      // payload bytes received
+    std::atomic<uint64_t> maxBatch{0};   // largest number of datagrams returned by one syscall
+    std::atomic<uint64_t> rejected{0};   // datagrams dropped by validatePacket() before any handler
+    std::atomic<uint64_t> kernelStamped{0};   // datagrams that carried a kernel receive timestamp
+    std::atomic<uint64_t> listeners{0};  // sockets bound
+    std::atomic<uint64_t> uringListeners{0};   // of those, receiving through io_uring
+    std::atomic<uint64_t> bufferStalls{0};     // io_uring receive paused: every provided buffer was in use
+    std::atomic<uint64_t> perListener[kMaxListeners] = {};   // datagrams received by each socket
+
+    double packetsPerSyscall() const {
+        uint64_t s = syscalls.load(std::memory_order_relaxed);
+        return s ? static_cast<double>(packets.load(std::memory_order_relaxed)) / s : 0.0;
+    }
+};
+
+// Run the UDP listener; call from a background thread. Blocks for the life of the process.
+// With more than one listener the kernel spreads senders over the sockets by address
+// hash, so every datagram from one rig is still received, in order, by a single thread.
 void startUDPListener();
+void startUDPListener(UDPListenerConfig config);
+
+const UDPListenerStats& getUDPListenerStats();
+
+// Validate one datagram and publish it on g_packetBus. Shared by the socket listeners
+// and session replay; safe to call from several threads. Packets of one stream take turns
+// to publish, packets of different streams publish in parallel.
+void handleDatagram(const uint8_t* data, size_t bytes, const ReceiveInfo& received);
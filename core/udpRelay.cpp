@@ -0,0 +1,184 @@
+#include "udpRelay.hpp"
+#include "packetDispatch.hpp"
+#include <iostream>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+UdpRelay g_relay;
+
+static const PacketTypeInfo* packetTypeByName(const std::string& name) {
+    for (uint8_t id = 0; id < kNumPacketTypes; ++id) {
+        const PacketTypeInfo* info = packetTypeInfo(id);
+        if (name == info->name) return info;
+    }
+    return nullptr;
+}
+
+bool parseRelayTarget(const std::string& spec, RelayTarget& out) {
+    RelayTarget target;
+    target.spec = spec;
+
+    size_t comma = spec.find(',');
+    std::string address = spec.substr(0, comma);
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0) {
+        std::cerr << "Relay target needs HOST:PORT: " << spec << "\n";
+        return false;
+    }
+    target.host = address.substr(0, colon);
+    int port = std::atoi(address.c_str() + colon + 1);
+    if (port <= 0 || port > 65535) {
+        std::cerr << "Invalid relay port: " << spec << "\n";
+        return false;
+    }
+    target.port = static_cast<uint16_t>(port);
+
+    // Listed types replace the default of everything
+    if (comma != std::string::npos) target.mask = 0;
+    while (comma != std::string::npos) {
+        size_t next = spec.find(',', comma + 1);
+        std::string item = spec.substr(comma + 1, next == std::string::npos ? std::string::npos : next - comma - 1);
+        comma = next;
+
+        double hz = 0.0;
+        size_t at = item.find('@');
+        if (at != std::string::npos) {
+            hz = std::atof(item.c_str() + at + 1);
+            item.resize(at);
+            if (hz <= 0.0) {
+                std::cerr << "Invalid relay rate for " << item << ": " << spec << "\n";
+                return false;
+            }
+        }
+
+        if (item == "all") {
+            target.mask = kAllPackets;
+            if (hz > 0.0) {
+                for (double& max : target.maxHz) max = hz;
+            }
+            continue;
+        }
+        const PacketTypeInfo* info = packetTypeByName(item);
+        if (!info) {
+            std::cerr << "Unknown packet type in relay target: " << item << "\n";
+            return false;
+        }
+        target.mask |= packetMask(info->id);
+        target.maxHz[info->id] = hz;
+    }
+
+    out = target;
+    return true;
+}
+
+UdpRelay::~UdpRelay() {
+    for (const auto& target : targets_) {
+        if (target->sock >= 0) close(target->sock);
+    }
+}
+
+bool UdpRelay::addTarget(const RelayTarget& config) {
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config.port);
+    if (inet_pton(AF_INET, config.host.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "Invalid relay address: " << config.host << "\n";
+        return false;
+    }
+
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        std::cerr << "Failed to create relay socket\n";
+        return false;
+    }
+    // Connected, so each send skips the route lookup
+    if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "Failed to set up relay to " << config.host << ":" << config.port << "\n";
+        close(sock);
+        return false;
+    }
+
+    std::unique_ptr<Target> target(new Target);
+    target->config = config;
+    target->sock = sock;
+    for (size_t id = 0; id < kNumPacketTypes; ++id) {
+        if (config.maxHz[id] > 0.0) target->intervalNs[id] = static_cast<uint64_t>(1e9 / config.maxHz[id]);
+    }
+    targets_.push_back(std::move(target));
+    return true;
+}
+
+void UdpRelay::attach(PacketBus& bus) {
+    uint32_t mask = 0;
+    for (const auto& target : targets_) mask |= target->config.mask;
+    if (mask == 0) return;
+    bus.subscribeRaw("relay", mask, [this](const uint8_t* data, size_t size, const ReceiveInfo& received) {
+        forward(data, size, received);
+    });
+}
+
+// The packet's stream's entry in its shard; a new stream takes a free entry, else the one
+// idle longest
+UdpRelay::StreamLimit& UdpRelay::limitFor(Target& target, const PacketHeader& header, const ReceiveInfo& received) {
+    StreamLimit* limits = target.limits[SequenceTracker::shardOf(header, received)];
+    size_t slot = 0;
+    for (size_t i = 0; i < kStreamsPerShard; ++i) {
+        if (limits[i].active && limits[i].sourceAddress == received.sourceAddress &&
+            limits[i].sessionUID == header.m_sessionUID) {
+            return limits[i];
+        }
+        if (limits[slot].active && (!limits[i].active || limits[i].lastNs < limits[slot].lastNs)) slot = i;
+    }
+    limits[slot] = StreamLimit{};
+    limits[slot].active = true;
+    limits[slot].sourceAddress = received.sourceAddress;
+    limits[slot].sessionUID = header.m_sessionUID;
+    return limits[slot];
+}
+
+// Listener threads, once per validated packet. Rate limits are per target, stream and type,
+// on receive time.
+void UdpRelay::forward(const uint8_t* data, size_t size, const ReceiveInfo& received) {
+    const PacketHeader& header = *reinterpret_cast<const PacketHeader*>(data);
+    const uint8_t id = header.m_packetId;
+    for (const auto& target : targets_) {
+        if (!(target->config.mask & packetMask(static_cast<PacketID>(id)))) continue;
+
+        if (target->intervalNs[id]) {
+            StreamLimit& limit = limitFor(*target, header, received);
+            limit.lastNs = received.monoNs;
+            if (received.monoNs < limit.nextNs[id]) {
+                target->decimated.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            limit.nextNs[id] = received.monoNs + target->intervalNs[id];
+        }
+
+        // MSG_DONTWAIT: a full send buffer fails the send instead of stalling ingest
+        if (send(target->sock, data, size, MSG_DONTWAIT) >= 0) {
+            target->forwarded.fetch_add(1, std::memory_order_relaxed);
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+            target->dropped.fetch_add(1, std::memory_order_relaxed);
+        } else if (target->errors.fetch_add(1, std::memory_order_relaxed) < 3) {
+            // ECONNREFUSED: nothing is listening there (yet); keep sending, it may start
+            std::cerr << "Relay to " << target->config.spec << ": " << std::strerror(errno) << "\n";
+        }
+    }
+}
+
+std::vector<RelayTargetStats> UdpRelay::stats() const {
+    std::vector<RelayTargetStats> out;
+    out.reserve(targets_.size());
+    for (const auto& target : targets_) {
+        out.push_back({target->config.spec,
+                       target->forwarded.load(std::memory_order_relaxed),
+                       target->decimated.load(std::memory_order_relaxed),
+                       target->dropped.load(std::memory_order_relaxed),
+                       target->errors.load(std::memory_order_relaxed)});
+    }
+    return out;
+}
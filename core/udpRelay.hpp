@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "packetBus.hpp"
+#include "sequenceTracker.hpp"
+
+// Where one relay subscriber wants packets, and which ones
+struct RelayTarget {
+    std::string spec;                        // as given on the command line, for stats
+    std::string host;                        // IPv4 address
+    uint16_t port = 20777;
+    uint32_t mask = kAllPackets;             // packet types forwarded
+    double maxHz[kNumPacketTypes] = {};      // per type: forward at most this often, 0 = every packet
+};
+
+// "HOST:PORT[,TYPE[@HZ]...]" with TYPE a text log name (motion, lap_data, ...) or "all".
+// No types forwards everything at full rate; "192.168.1.20:20777,all,motion@20" forwards
+// everything with motion cut to 20 Hz. False (and a message) on a malformed spec.
+bool parseRelayTarget(const std::string& spec, RelayTarget& out);
+
+struct RelayTargetStats {
+    std::string spec;
+    uint64_t forwarded;
+    uint64_t decimated;   // skipped by the target's rate limit
+    uint64_t dropped;     // send buffer full (EAGAIN / ENOBUFS): the subscriber is backed up
+    uint64_t errors;      // any other send failure, e.g. nothing listening on a local port
+};
+
+// Re-sends validated datagrams, unmodified, to other listeners - a second dashboard, another
+// machine on the LAN - since the game itself can only send to one address.
+//
+// Runs inline on the ingest thread and sends straight from the receive slab, no copy. Every
+// target has its own non-blocking socket: a target that can't keep up fills its own send
+// buffer and loses its own packets, counted as drops, and ingest never waits on it.
+//
+// Rate limits apply per sender stream (address + session UID): with two rigs and
+// motion@20, each rig's motion reaches the target at 20 Hz.
+class UdpRelay {
+public:
+    UdpRelay() = default;
+    ~UdpRelay();
+
+    UdpRelay(const UdpRelay&) = delete;
+    UdpRelay& operator=(const UdpRelay&) = delete;
+
+    // Before attach(); false (and a message) if the target's socket can't be set up
+    bool addTarget(const RelayTarget& target);
+    size_t targets() const { return targets_.size(); }
+
+    // Forward every packet type any target wants. Subscribe ahead of the live views so
+    // relayed packets leave before local processing.
+    void attach(PacketBus& bus);
+
+    std::vector<RelayTargetStats> stats() const;
+
+private:
+    // One sender stream's rate limit state
+    struct StreamLimit {
+        bool active;
+        uint32_t sourceAddress;
+        uint64_t sessionUID;
+        uint64_t lastNs;                    // newest packet, picks the entry to reuse when full
+        uint64_t nextNs[kNumPacketTypes];   // earliest receive time of the next send
+    };
+    static constexpr size_t kStreamsPerShard = 4;
+
+    struct Target {
+        RelayTarget config;
+        int sock = -1;
+        uint64_t intervalNs[kNumPacketTypes] = {};
+        // Kept per sequence tracker shard: handleDatagram() holds the shard's publish lock
+        // while the relay runs, so each table has one writer at a time
+        StreamLimit limits[SequenceTracker::kShards][kStreamsPerShard] = {};
+        std::atomic<uint64_t> forwarded{0};
+        std::atomic<uint64_t> decimated{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> errors{0};
+    };
+
+    void forward(const uint8_t* data, size_t size, const ReceiveInfo& received);
+    static StreamLimit& limitFor(Target& target, const PacketHeader& header, const ReceiveInfo& received);
+
+    std::vector<std::unique_ptr<Target>> targets_;
+};
+
+extern UdpRelay g_relay;
@@ -0,0 +1,144 @@
+#include "CarHistory.hpp"
+#include <new>
+
+LiveInputSample toInputSample(const PacketHeader& header, const CarTelemetryData& car, uint64_t receivedMonoNs) {
+    LiveInputSample sample;
+
+    sample.throttle = car.m_throttle;
+    sample.brake = car.m_brake;
+    sample.steer = car.m_steer;
+    sample.timestampMs = static_cast<uint64_t>(header.m_sessionTime*1000);
+
+    // Populate extended telemetry fields
+    sample.speed = car.m_speed;
+    sample.engineRPM = car.m_engineRPM;
+    // Store clutch as an integer percentage to avoid noisy floating prints
+    sample.clutch = static_cast<uint8_t>(static_cast<int>(car.m_clutch));
+    sample.gear = car.m_gear;
+    sample.drs = car.m_drs;
+    sample.revLightsPercent = car.m_revLightsPercent;
+    sample.receivedMonoNs = receivedMonoNs;
+    return sample;
+}
+
+LivePositionSample toPositionSample(const PacketHeader& header, const CarMotionData& car, uint64_t receivedMonoNs) {
+    return {
+        car.m_worldPositionX,
+        car.m_worldPositionY,
+        car.m_worldPositionZ,
+        static_cast<uint64_t>(header.m_sessionTime * 1000),
+        receivedMonoNs
+    };
+}
+
+// Slots for `count` entries at `at`, constructed in place
+template<typename Slot>
+static Slot* constructSlots(unsigned char* at, size_t count) {
+    Slot* slots = reinterpret_cast<Slot*>(at);
+    for (size_t i = 0; i < count; ++i) {
+        new (&slots[i]) Slot();
+    }
+    return slots;
+}
+
+void CarHistory::configure(const LiveHistoryConfig& config) {
+    using InputSlot = RingBuffer<LiveInputSample>::Slot;
+    using PositionSlot = RingBuffer<LivePositionSample>::Slot;
+    using BucketSlot = TieredHistory::BucketSlot;
+
+    const size_t samples = config.fullRateSamples() ? config.fullRateSamples() : 1;
+    size_t bucketCount[NUM_HISTORY_TIERS];
+    for (size_t t = 0; t < NUM_HISTORY_TIERS; ++t) {
+        bucketCount[t] = TieredHistory::capacity(config, static_cast<HistoryTier>(t));
+    }
+
+    // Lay every ring out back to back, each on its own cache line
+    size_t offset = 0;
+    auto reserve = [&offset](size_t bytes) {
+        offset = (offset + 63) & ~static_cast<size_t>(63);
+        size_t at = offset;
+        offset += bytes;
+        return at;
+    };
+    size_t inputAt[kMaxCars], positionAt[kMaxCars], tierAt[kMaxCars][NUM_HISTORY_TIERS];
+    for (size_t car = 0; car < kMaxCars; ++car) {
+        inputAt[car] = reserve(samples * sizeof(InputSlot));
+        positionAt[car] = reserve(samples * sizeof(PositionSlot));
+        for (size_t t = 0; t < NUM_HISTORY_TIERS; ++t) {
+            tierAt[car][t] = reserve(bucketCount[t] * sizeof(BucketSlot));
+        }
+    }
+
+    arenaBytes_ = offset;
+    arena_.reset(new unsigned char[arenaBytes_ + 64]);
+    unsigned char* base = arena_.get() + (64 - reinterpret_cast<uintptr_t>(arena_.get()) % 64) % 64;
+
+    for (size_t car = 0; car < kMaxCars; ++car) {
+        inputs_[car].attach(constructSlots<InputSlot>(base + inputAt[car], samples), samples);
+        positions_[car].attach(constructSlots<PositionSlot>(base + positionAt[car], samples), samples);
+
+        BucketSlot* tierSlots[NUM_HISTORY_TIERS];
+        for (size_t t = 0; t < NUM_HISTORY_TIERS; ++t) {
+            tierSlots[t] = constructSlots<BucketSlot>(base + tierAt[car][t], bucketCount[t]);
+        }
+        tiers_[car].attach(config, tierSlots);
+    }
+}
+
+void CarHistory::pushTelemetry(const PacketCarTelemetryData& packet, uint64_t receivedMonoNs) {
+    if (!arena_) return;
+    for (size_t car = 0; car < kMaxCars; ++car) {
+        LiveInputSample sample = toInputSample(packet.m_header, packet.m_carTelemetryData[car], receivedMonoNs);
+        inputs_[car].push(sample);
+        tiers_[car].push(sample);
+    }
+}
+
+void CarHistory::pushMotion(const PacketMotionData& packet, uint64_t receivedMonoNs) {
+    if (!arena_) return;
+    for (size_t car = 0; car < kMaxCars; ++car) {
+        positions_[car].push(toPositionSample(packet.m_header, packet.m_carMotionData[car], receivedMonoNs));
+    }
+}
+
+void CarHistory::rewind(uint64_t toMs) {
+    for (TieredHistory& tiers : tiers_) {
+        tiers.rewind(toMs);
+    }
+    rewinds_.push({toMs, inputs_[0].written(), positions_[0].written()});
+}
+
+size_t CarHistory::readRewindsSince(size_t& cursor, LiveRewind* out, size_t maxCount) const {
+    return rewinds_.readSince(cursor, out, maxCount);
+}
+
+size_t CarHistory::readSince(size_t car, size_t& cursor, LiveInputSample* out, size_t maxCount,
+                             bool* overrun) const {
+    return car < kMaxCars ? inputs_[car].readSince(cursor, out, maxCount, overrun) : 0;
+}
+
+size_t CarHistory::readPositionsSince(size_t car, size_t& cursor, LivePositionSample* out, size_t maxCount,
+                                      bool* overrun) const {
+    return car < kMaxCars ? positions_[car].readSince(cursor, out, maxCount, overrun) : 0;
+}
+
+size_t CarHistory::readBucketsSince(size_t car, HistoryTier tier, size_t& cursor, LiveInputBucket* out,
+                                    size_t maxCount, bool* overrun) const {
+    return car < kMaxCars ? tiers_[car].tier(tier).readSince(cursor, out, maxCount, overrun) : 0;
+}
+
+CarMask CarHistory::peekLatest(CarMask cars, LiveInputSample out[kMaxCars]) const {
+    CarMask filled = 0;
+    for (size_t car = 0; car < kMaxCars; ++car) {
+        if ((cars & carMask(car)) && inputs_[car].peekLatest(out[car])) filled |= carMask(car);
+    }
+    return filled;
+}
+
+CarMask CarHistory::peekLatestPositions(CarMask cars, LivePositionSample out[kMaxCars]) const {
+    CarMask filled = 0;
+    for (size_t car = 0; car < kMaxCars; ++car) {
+        if ((cars & carMask(car)) && positions_[car].peekLatest(out[car])) filled |= carMask(car);
+    }
+    return filled;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "packetStructs.hpp"
+#include "LiveTelemetry.hpp"
+#include "TieredHistory.hpp"
+
+// Bit mask of car indices (bit i = car i) for the multi-car reads
+using CarMask = uint32_t;
+constexpr CarMask kAllCars = (1u << kMaxCars) - 1;
+constexpr CarMask carMask(size_t car) { return 1u << car; }
+
+// Live samples for one car of a packet received at receivedMonoNs (steady_clock)
+LiveInputSample toInputSample(const PacketHeader& header, const CarTelemetryData& car, uint64_t receivedMonoNs);
+LivePositionSample toPositionSample(const PacketHeader& header, const CarMotionData& car, uint64_t receivedMonoNs);
+
+// Input / position history and downsampled tiers for every car, not just the player.
+// configure() carves all 22 x (inputs, positions, tiers) rings out of one arena; after
+// that nothing allocates, so memory is fixed at 22 x (tiers x samples). Single writer.
+class CarHistory {
+public:
+    void configure(const LiveHistoryConfig& config);   // before ingest starts
+
+    void pushTelemetry(const PacketCarTelemetryData& packet, uint64_t receivedMonoNs);
+    void pushMotion(const PacketMotionData& packet, uint64_t receivedMonoNs);
+    // Flashback: drops rewound tier buckets (see TieredHistory::rewind) and records a
+    // LiveRewind at this store's indices, which apply to every car
+    void rewind(uint64_t toMs);
+    size_t readRewindsSince(size_t& cursor, LiveRewind* out, size_t maxCount) const;
+
+    // One car, incremental (see RingBuffer::readSince)
+    size_t readSince(size_t car, size_t& cursor, LiveInputSample* out, size_t maxCount,
+                     bool* overrun = nullptr) const;
+    size_t readPositionsSince(size_t car, size_t& cursor, LivePositionSample* out, size_t maxCount,
+                              bool* overrun = nullptr) const;
+    size_t readBucketsSince(size_t car, HistoryTier tier, size_t& cursor, LiveInputBucket* out,
+                            size_t maxCount, bool* overrun = nullptr) const;
+
+    // A set of cars: out[car] is filled for every car in the returned mask
+    CarMask peekLatest(CarMask cars, LiveInputSample out[kMaxCars]) const;
+    CarMask peekLatestPositions(CarMask cars, LivePositionSample out[kMaxCars]) const;
+
+    size_t arenaBytes() const { return arenaBytes_; }
+
+private:
+    RingBuffer<LiveInputSample> inputs_[kMaxCars];
+    RingBuffer<LivePositionSample> positions_[kMaxCars];
+    TieredHistory tiers_[kMaxCars];
+    RingBuffer<LiveRewind> rewinds_{64};
+    std::unique_ptr<unsigned char[]> arena_;
+    size_t arenaBytes_ = 0;
+};
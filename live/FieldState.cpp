@@ -0,0 +1,117 @@
+#include "FieldState.hpp"
+#include <cstring>
+
+FieldState::FieldState() {
+    std::memset(buffers_, 0, sizeof(buffers_));
+}
+
+FieldSnapshot& FieldState::beginPacket(const PacketHeader& header, PacketID id) {
+    uint64_t p = published_.load(std::memory_order_relaxed);
+
+    // First packet of a new frame: publish the one we were building
+    if (backDirty_ && header.m_frameIdentifier != buffers_[(p + 1) & 1].frameIdentifier) {
+        published_.store(++p, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        backDirty_ = false;
+    }
+
+    FieldSnapshot& back = buffers_[(p + 1) & 1];
+    if (!backDirty_) {
+        // Start from the last published frame so types sent less often carry over
+        std::memcpy(&back, &buffers_[p & 1], sizeof(FieldSnapshot));
+        back.frameIdentifier = header.m_frameIdentifier;
+        back.updatedMask = 0;
+        backDirty_ = true;
+    }
+    back.sessionTime = header.m_sessionTime;
+    back.playerCarIndex = header.m_playerCarIndex;
+    back.updatedMask |= 1u << id;
+    return back;
+}
+
+void FieldState::applyCarTelemetry(const PacketCarTelemetryData& packet) {
+    FieldSnapshot& f = beginPacket(packet.m_header, CAR_TELEMETRY);
+    for (size_t i = 0; i < kMaxCars; ++i) {
+        const CarTelemetryData& car = packet.m_carTelemetryData[i];
+        f.speed[i] = car.m_speed;
+        f.throttle[i] = car.m_throttle;
+        f.brake[i] = car.m_brake;
+        f.steer[i] = car.m_steer;
+        f.gear[i] = car.m_gear;
+        f.engineRPM[i] = car.m_engineRPM;
+        f.drs[i] = car.m_drs;
+    }
+}
+
+void FieldState::applyMotion(const PacketMotionData& packet) {
+    FieldSnapshot& f = beginPacket(packet.m_header, MOTION);
+    for (size_t i = 0; i < kMaxCars; ++i) {
+        const CarMotionData& car = packet.m_carMotionData[i];
+        f.worldX[i] = car.m_worldPositionX;
+        f.worldY[i] = car.m_worldPositionY;
+        f.worldZ[i] = car.m_worldPositionZ;
+        f.gForceLateral[i] = car.m_gForceLateral;
+        f.gForceLongitudinal[i] = car.m_gForceLongitudinal;
+    }
+}
+
+void FieldState::applyLapData(const PacketLapData& packet) {
+    FieldSnapshot& f = beginPacket(packet.m_header, LAP_DATA);
+    for (size_t i = 0; i < kMaxCars; ++i) {
+        const LapData& car = packet.m_lapData[i];
+        f.lapDistance[i] = car.m_lapDistance;
+        f.totalDistance[i] = car.m_totalDistance;
+        f.currentLapTimeMs[i] = car.m_currentLapTimeInMS;
+        f.lastLapTimeMs[i] = car.m_lastLapTimeInMS;
+        f.deltaToCarInFrontMs[i] = car.m_deltaToCarInFrontInMS;
+        f.deltaToLeaderMs[i] = car.m_deltaToRaceLeaderInMS;
+        f.carPosition[i] = car.m_carPosition;
+        f.currentLapNum[i] = car.m_currentLapNum;
+        f.pitStatus[i] = car.m_pitStatus;
+        f.resultStatus[i] = car.m_resultStatus;
+    }
+}
+
+void FieldState::applyCarStatus(const PacketCarStatusData& packet) {
+    FieldSnapshot& f = beginPacket(packet.m_header, CAR_STATUS);
+    for (size_t i = 0; i < kMaxCars; ++i) {
+        const CarStatusData& car = packet.m_carStatusData[i];
+        f.visualTyreCompound[i] = car.m_visualTyreCompound;
+        f.tyresAgeLaps[i] = car.m_tyresAgeLaps;
+        f.fuelInTank[i] = car.m_fuelInTank;
+        f.fuelRemainingLaps[i] = car.m_fuelRemainingLaps;
+        f.ersStoreEnergy[i] = car.m_ersStoreEnergy;
+        f.vehicleFiaFlags[i] = car.m_vehicleFiaFlags;
+    }
+}
+
+void FieldState::applyCarDamage(const PacketCarDamageData& packet) {
+    FieldSnapshot& f = beginPacket(packet.m_header, CAR_DAMAGE);
+    for (size_t i = 0; i < kMaxCars; ++i) {
+        const CarDamageData& car = packet.m_carDamageData[i];
+        for (size_t w = 0; w < 4; ++w) {
+            f.tyresWear[w][i] = car.m_tyresWear[w];
+        }
+        f.frontLeftWingDamage[i] = car.m_frontLeftWingDamage;
+        f.frontRightWingDamage[i] = car.m_frontRightWingDamage;
+        f.rearWingDamage[i] = car.m_rearWingDamage;
+        f.floorDamage[i] = car.m_floorDamage;
+        f.engineDamage[i] = car.m_engineDamage;
+    }
+}
+
+void FieldState::applyParticipants(const PacketParticipantsData& packet) {
+    FieldSnapshot& f = beginPacket(packet.m_header, PARTICIPANTS);
+    f.numActiveCars = packet.m_numActiveCars;
+}
+
+bool FieldState::read(FieldSnapshot& out) const {
+    for (;;) {
+        uint64_t p = published_.load(std::memory_order_acquire);
+        if (p == 0) return false;
+        std::memcpy(&out, &buffers_[p & 1], sizeof(FieldSnapshot));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // The buffer we copied becomes the writer's back buffer after the next publish
+        if (published_.load(std::memory_order_relaxed) == p) return true;
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "packetStructs.hpp"
+#include "packetWriters.hpp"
+
+// Latest values for the whole field, one array per field indexed by car (structure of
+// arrays), so whole-field analytics walk contiguous memory instead of packets.
+struct FieldSnapshot {
+    uint32_t frameIdentifier;   // m_frameIdentifier of the packets folded in
+    float sessionTime;
+    uint8_t playerCarIndex;
+    uint8_t numActiveCars;      // from the participants packet, 0 until one arrives
+    uint32_t updatedMask;       // packet types (1 << PacketID) seen for this frame
+
+    // Car telemetry
+    uint16_t speed[kMaxCars];           // km/h
+    float throttle[kMaxCars];
+    float brake[kMaxCars];
+    float steer[kMaxCars];
+    int8_t gear[kMaxCars];
+    uint16_t engineRPM[kMaxCars];
+    uint8_t drs[kMaxCars];
+
+    // Motion
+    float worldX[kMaxCars];
+    float worldY[kMaxCars];
+    float worldZ[kMaxCars];
+    float gForceLateral[kMaxCars];
+    float gForceLongitudinal[kMaxCars];
+
+    // Lap data
+    float lapDistance[kMaxCars];        // metres into the current lap
+    float totalDistance[kMaxCars];
+    uint32_t currentLapTimeMs[kMaxCars];
+    uint32_t lastLapTimeMs[kMaxCars];
+    uint16_t deltaToCarInFrontMs[kMaxCars];
+    uint16_t deltaToLeaderMs[kMaxCars];
+    uint8_t carPosition[kMaxCars];
+    uint8_t currentLapNum[kMaxCars];
+    uint8_t pitStatus[kMaxCars];
+    uint8_t resultStatus[kMaxCars];
+
+    // Car status
+    uint8_t visualTyreCompound[kMaxCars];
+    uint8_t tyresAgeLaps[kMaxCars];
+    float fuelInTank[kMaxCars];
+    float fuelRemainingLaps[kMaxCars];
+    float ersStoreEnergy[kMaxCars];
+    int8_t vehicleFiaFlags[kMaxCars];
+
+    // Car damage, tyres in RL, RR, FL, FR order like the packets
+    float tyresWear[4][kMaxCars];
+    uint8_t frontLeftWingDamage[kMaxCars];
+    uint8_t frontRightWingDamage[kMaxCars];
+    uint8_t rearWingDamage[kMaxCars];
+    uint8_t floorDamage[kMaxCars];
+    uint8_t engineDamage[kMaxCars];
+};
+
+// Double-buffered whole-field store. The ingest thread folds every packet of a frame into
+// the back buffer; the first packet of a new m_frameIdentifier publishes it, so readers
+// always see one complete frame (one frame behind the newest packet). Reads are lock-free
+// and retry if the writer swapped buffers mid-copy.
+class FieldState {
+public:
+    FieldState();
+
+    // Writer side (ingest thread only)
+    void applyCarTelemetry(const PacketCarTelemetryData& packet);
+    void applyMotion(const PacketMotionData& packet);
+    void applyLapData(const PacketLapData& packet);
+    void applyCarStatus(const PacketCarStatusData& packet);
+    void applyCarDamage(const PacketCarDamageData& packet);
+    void applyParticipants(const PacketParticipantsData& packet);
+
+    // Copy the latest complete frame; false until the first frame is published
+    bool read(FieldSnapshot& out) const;
+
+    uint64_t framesPublished() const { return published_.load(std::memory_order_acquire); }
+
+private:
+    FieldSnapshot& beginPacket(const PacketHeader& header, PacketID id);
+
+    FieldSnapshot buffers_[2];
+    bool backDirty_ = false;
+    alignas(64) std::atomic<uint64_t> published_{0};   // front buffer is buffers_[published_ & 1]
+};
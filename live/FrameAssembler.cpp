@@ -0,0 +1,112 @@
+#include "FrameAssembler.hpp"
+#include <cstring>
+
+void FrameAssembler::add(const uint8_t* data, const ReceiveInfo& received) {
+    const PacketHeader& header = *reinterpret_cast<const PacketHeader*>(data);
+
+    if (!inSession_ || header.m_sessionUID != sessionUID_) {
+        // Frame ids restart with a session: finish the old one first
+        flush();
+        inSession_ = true;
+        sessionUID_ = header.m_sessionUID;
+        haveEmitted_ = false;
+    }
+
+    // Frames whose deadline passed go out as they are
+    for (Slot& slot : pool_) {
+        if (slot.used && received.monoNs > slot.frame.firstReceivedMonoNs + config_.deadlineNs) {
+            emitUpTo(slot.frame.overallFrameIdentifier);
+        }
+    }
+
+    if (haveEmitted_ && header.m_overallFrameIdentifier <= lastOverall_) {
+        bump(stats_.late);
+        return;
+    }
+
+    Slot* slot = slotFor(header, received.monoNs);
+    FrameSnapshot& frame = slot->frame;
+    switch (header.m_packetId) {
+        case MOTION:        std::memcpy(&frame.motion, data, sizeof(frame.motion)); break;
+        case CAR_TELEMETRY: std::memcpy(&frame.telemetry, data, sizeof(frame.telemetry)); break;
+        case LAP_DATA:      std::memcpy(&frame.lapData, data, sizeof(frame.lapData)); break;
+        case CAR_STATUS:    std::memcpy(&frame.carStatus, data, sizeof(frame.carStatus)); break;
+        default: return;
+    }
+    frame.presentMask |= packetMask(static_cast<PacketID>(header.m_packetId));
+
+    if ((frame.presentMask & config_.expectedMask) == config_.expectedMask) {
+        frame.complete = true;
+        emitUpTo(frame.overallFrameIdentifier);
+    }
+}
+
+FrameAssembler::Slot* FrameAssembler::slotFor(const PacketHeader& header, uint64_t receivedMonoNs) {
+    Slot* free = nullptr;
+    for (Slot& slot : pool_) {
+        if (!slot.used) {
+            if (!free) free = &slot;
+        } else if (slot.frame.overallFrameIdentifier == header.m_overallFrameIdentifier) {
+            return &slot;
+        }
+    }
+
+    if (!free) {
+        // Every slot is waiting on a packet: the oldest frame goes out incomplete
+        Slot* oldest = nullptr;
+        for (Slot& slot : pool_) {
+            if (!oldest || slot.frame.overallFrameIdentifier < oldest->frame.overallFrameIdentifier) {
+                oldest = &slot;
+            }
+        }
+        bump(stats_.evicted);
+        emitUpTo(oldest->frame.overallFrameIdentifier);
+        free = oldest;
+    }
+
+    FrameSnapshot& frame = free->frame;
+    free->used = true;
+    frame.sessionUID = header.m_sessionUID;
+    frame.overallFrameIdentifier = header.m_overallFrameIdentifier;
+    frame.frameIdentifier = header.m_frameIdentifier;
+    frame.sessionTime = header.m_sessionTime;
+    frame.playerCarIndex = header.m_playerCarIndex;
+    frame.presentMask = 0;
+    frame.complete = false;
+    frame.afterFlashback = false;
+    frame.firstReceivedMonoNs = receivedMonoNs;
+    return free;
+}
+
+void FrameAssembler::emitUpTo(uint32_t overallFrame) {
+    // Oldest first, so the ring stays in frame order
+    for (;;) {
+        Slot* oldest = nullptr;
+        for (Slot& slot : pool_) {
+            if (slot.used && slot.frame.overallFrameIdentifier <= overallFrame &&
+                (!oldest || slot.frame.overallFrameIdentifier < oldest->frame.overallFrameIdentifier)) {
+                oldest = &slot;
+            }
+        }
+        if (!oldest) return;
+        emit(*oldest);
+    }
+}
+
+void FrameAssembler::emit(Slot& slot) {
+    FrameSnapshot& frame = slot.frame;
+    frame.afterFlashback = haveEmitted_ && frame.frameIdentifier < lastFrame_;
+    bump(frame.complete ? stats_.complete : stats_.partial);
+
+    frames_.push(frame);
+    haveEmitted_ = true;
+    lastOverall_ = frame.overallFrameIdentifier;
+    lastFrame_ = frame.frameIdentifier;
+    slot.used = false;
+}
+
+void FrameAssembler::flush() {
+    for (Slot& slot : pool_) {
+        if (slot.used) emitUpTo(slot.frame.overallFrameIdentifier);
+    }
+}
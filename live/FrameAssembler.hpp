@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "packetStructs.hpp"
+#include "packetQueue.hpp"
+#include "packetBus.hpp"
+#include "RingBuffer.hpp"
+
+// Packet types joined into a FrameSnapshot; the game sends each of them once per frame
+constexpr uint32_t kFramePackets = packetMask(MOTION) | packetMask(CAR_TELEMETRY) |
+                                   packetMask(LAP_DATA) | packetMask(CAR_STATUS);
+
+// Every per-frame packet for one m_overallFrameIdentifier, so values derived from
+// several packet types (position + speed, lap distance + inputs, ...) come from the
+// same frame. Only the packets in presentMask are valid.
+struct FrameSnapshot {
+    uint64_t sessionUID;
+    uint32_t overallFrameIdentifier;
+    uint32_t frameIdentifier;
+    float sessionTime;
+    uint8_t playerCarIndex;
+    uint32_t presentMask;          // packetMask() of the packets that arrived
+    bool complete;                 // all expected packets arrived (else the deadline passed)
+    bool afterFlashback;           // frameIdentifier went back: session time rewound to here
+    uint64_t firstReceivedMonoNs;  // steady_clock receive time of the frame's first packet
+
+    PacketMotionData motion;
+    PacketCarTelemetryData telemetry;
+    PacketLapData lapData;
+    PacketCarStatusData carStatus;
+
+    bool has(PacketID id) const { return (presentMask & packetMask(id)) != 0; }
+};
+
+struct FrameAssemblerStats {
+    std::atomic<uint64_t> complete{0};   // frames emitted with every expected packet
+    std::atomic<uint64_t> partial{0};    // emitted incomplete: deadline, eviction or a newer frame completed
+    std::atomic<uint64_t> evicted{0};    // of those, pushed out because every slot was in use
+    std::atomic<uint64_t> late{0};       // packets for a frame that was already emitted
+};
+
+// Joins the per-frame packets by m_overallFrameIdentifier in a small fixed pool of frame
+// slots. A frame is emitted once the expected set has arrived, or as a partial frame
+// when its deadline passes, the pool is full, or a newer frame completes first; frames
+// always leave in overall-frame order. Emitted frames go into a seqlock ring for any
+// number of readers. No allocation after construction; add() is single-writer.
+class FrameAssembler {
+public:
+    static constexpr size_t kPoolSize = 8;
+    static constexpr size_t kHistoryFrames = 120;   // 2 s at 60 Hz
+
+    struct Config {
+        uint32_t expectedMask = kFramePackets;
+        uint64_t deadlineNs = 50000000;   // 50 ms after the frame's first packet
+    };
+
+    FrameAssembler() : frames_(kHistoryFrames) {}
+    explicit FrameAssembler(const Config& config) : config_(config), frames_(kHistoryFrames) {}
+
+    // Ingest thread: one validated packet of a type in kFramePackets
+    void add(const uint8_t* data, const ReceiveInfo& received);
+
+    // Emit every frame still being assembled (e.g. at the end of a replay)
+    void flush();
+
+    size_t readSince(size_t& cursor, FrameSnapshot* out, size_t maxCount, bool* overrun = nullptr) const {
+        return frames_.readSince(cursor, out, maxCount, overrun);
+    }
+    bool peekLatest(FrameSnapshot& out) const { return frames_.peekLatest(out); }
+
+    const FrameAssemblerStats& stats() const { return stats_; }
+
+private:
+    struct Slot {
+        bool used;
+        FrameSnapshot frame;
+    };
+
+    Slot* slotFor(const PacketHeader& header, uint64_t receivedMonoNs);
+    void emitUpTo(uint32_t overallFrame);   // every pending frame up to and including this one
+    void emit(Slot& slot);
+
+    static void bump(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Config config_;
+    Slot pool_[kPoolSize] = {};
+    bool inSession_ = false;
+    uint64_t sessionUID_ = 0;
+    bool haveEmitted_ = false;
+    uint32_t lastOverall_ = 0;      // newest frame emitted
+    uint32_t lastFrame_ = 0;
+    RingBuffer<FrameSnapshot> frames_;
+    FrameAssemblerStats stats_;
+};
@@ -0,0 +1,25 @@
+#include "FramePacer.hpp"
+#include <thread>
+
+FramePacer::FramePacer(double hz)
+    : hz_(hz > 0.0 ? hz : 60.0),
+      period_(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz_))),
+      next_(Clock::now() + period_) {}
+
+void FramePacer::wait() {
+    iterations_++;
+    Clock::time_point now = Clock::now();
+    if (now < next_) {
+        std::this_thread::sleep_until(next_);
+        next_ += period_;
+        return;
+    }
+    if (now - next_ >= period_) {
+        // A whole period behind (window dragged, machine busy): resync, no catch-up burst
+        late_++;
+        next_ = now + period_;
+        return;
+    }
+    // Slightly late: keep the original schedule so the average rate holds
+    next_ += period_;
+}
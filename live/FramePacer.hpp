@@ -0,0 +1,29 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Paces a loop to a fixed rate against absolute deadlines: the loop's own work counts
+// toward the period instead of being added to it, so a 16 ms frame at 60 Hz sleeps
+// ~0.7 ms, not 16. A loop already held to the rate elsewhere (vsync) never sleeps here.
+// One that falls more than a period behind starts over from now instead of running a
+// burst of catch-up iterations.
+class FramePacer {
+public:
+    explicit FramePacer(double hz);
+
+    // End of an iteration: sleep until the next deadline
+    void wait();
+
+    double hz() const { return hz_; }
+    uint64_t iterations() const { return iterations_; }
+    uint64_t late() const { return late_; }   // iterations that overran their whole period
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    double hz_;
+    Clock::duration period_;
+    Clock::time_point next_;
+    uint64_t iterations_ = 0;
+    uint64_t late_ = 0;
+};
@@ -1,20 +1,26 @@
 #include "../live/LiveTelemetry.hpp"
+#include "../live/PlotWindow.hpp"
 #include <imgui.h>
 #include <implot.h>
 #include <vector>
 
-void DrawInputsWindow() {
+void DrawInputsWindow(const LiveTelemetry& live) {
+    static size_t cursor = 0;
+    static PlotWindow<float> throttle(512);
+    static PlotWindow<float> brake(512);
+
+    // Append only what arrived since the last frame
     LiveInputSample history[512];
-    size_t count = LiveTelemetry::copyHistory(history, 512);
-    
-    static std::vector<float> throttle;
-    static std::vector<float> brake;
-    throttle.resize(count);
-    brake.resize(count);
+    bool overrun = false;
+    size_t count = live.readSince(cursor, history, 512, &overrun);
+    if (overrun) {
+        throttle.clear();
+        brake.clear();
+    }
 
     for (size_t i = 0; i < count; i++) {
-        throttle[i] = history[i].throttle;
-        brake[i]    = history[i].brake;
+        throttle.push(history[i].throttle);
+        brake.push(history[i].brake);
     }
 
     ImGui::Begin("Inputs");
@@ -0,0 +1,68 @@
+#include "LiveSubscribers.hpp"
+#include "SessionRegistry.hpp"
+#include "latencyHistogram.hpp"
+
+// Every handler below first finds the packet's session; after the first packet of a
+// session that is one key compare against the previous packet's session.
+
+static void onCarTelemetry(const PacketCarTelemetryData& packet, const ReceiveInfo& received) {
+    // Spectator and broadcast sessions have no player car (index 255)
+    if (packet.m_header.m_playerCarIndex >= kMaxCars) return;
+    const CarTelemetryData& carData = packet.m_carTelemetryData[packet.m_header.m_playerCarIndex];
+    LiveSession& session = g_sessions.route(packet.m_header, received);
+    session.player.pushInput(toInputSample(packet.m_header, carData, received.monoNs));
+}
+
+static void onMotion(const PacketMotionData& packet, const ReceiveInfo& received) {
+    if (packet.m_header.m_playerCarIndex >= kMaxCars) return;
+    const CarMotionData& motionData = packet.m_carMotionData[packet.m_header.m_playerCarIndex];
+    LiveSession& session = g_sessions.route(packet.m_header, received);
+    session.player.pushPosition(toPositionSample(packet.m_header, motionData, received.monoNs));
+}
+
+static void onSession(const PacketSessionData& packet, const ReceiveInfo& received) {
+    StaticInfo& info = g_sessions.route(packet.m_header, received).info;
+    if(packet.m_trackId != info.track_id) {
+        info.track_id = packet.m_trackId;
+    }
+}
+
+// Shorthand for the whole-field and per-car stores: the session a typed packet belongs to
+template<typename Packet>
+static LiveSession& sessionOf(const Packet& packet, const ReceiveInfo& received) {
+    return g_sessions.route(packet.m_header, received);
+}
+
+void subscribeLiveViews(PacketBus& bus) {
+    // Flashbacks are announced by the listener's sequence tracker ahead of the packets
+    g_sequenceTracker.onFlashback([](const FlashbackEvent& event) {
+        g_sessions.route(SessionKey{event.sourceAddress, event.sessionUID}, monotonicNowNs()).rewind(event);
+    });
+
+    // First on the bus, so a new session exists before any store is written
+    bus.subscribeRaw("sessions", kAllPackets, [](const uint8_t* data, size_t, const ReceiveInfo& r) {
+        LiveSession& session = g_sessions.route(*reinterpret_cast<const PacketHeader*>(data), r);
+        session.packets.store(session.packets.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    });
+
+    bus.subscribe<PacketCarTelemetryData>("live_inputs", &onCarTelemetry);
+    bus.subscribe<PacketMotionData>("live_positions", &onMotion);
+    bus.subscribe<PacketSessionData>("static_info", &onSession);
+
+    // Whole-field store, every car
+    bus.subscribe<PacketCarTelemetryData>("field_telemetry", [](const PacketCarTelemetryData& p, const ReceiveInfo& r) { sessionOf(p, r).field.applyCarTelemetry(p); });
+    bus.subscribe<PacketMotionData>("field_motion", [](const PacketMotionData& p, const ReceiveInfo& r) { sessionOf(p, r).field.applyMotion(p); });
+    bus.subscribe<PacketLapData>("field_lap_data", [](const PacketLapData& p, const ReceiveInfo& r) { sessionOf(p, r).field.applyLapData(p); });
+    bus.subscribe<PacketCarStatusData>("field_status", [](const PacketCarStatusData& p, const ReceiveInfo& r) { sessionOf(p, r).field.applyCarStatus(p); });
+    bus.subscribe<PacketCarDamageData>("field_damage", [](const PacketCarDamageData& p, const ReceiveInfo& r) { sessionOf(p, r).field.applyCarDamage(p); });
+    bus.subscribe<PacketParticipantsData>("field_participants", [](const PacketParticipantsData& p, const ReceiveInfo& r) { sessionOf(p, r).field.applyParticipants(p); });
+
+    // Per-frame packets joined by overall frame id
+    bus.subscribeRaw("frame_assembler", kFramePackets, [](const uint8_t* data, size_t, const ReceiveInfo& r) {
+        g_sessions.route(*reinterpret_cast<const PacketHeader*>(data), r).frames.add(data, r);
+    });
+
+    // Per-car history rings, every car
+    bus.subscribe<PacketCarTelemetryData>("car_history_telemetry", [](const PacketCarTelemetryData& p, const ReceiveInfo& r) { sessionOf(p, r).cars.pushTelemetry(p, r.monoNs); });
+    bus.subscribe<PacketMotionData>("car_history_motion", [](const PacketMotionData& p, const ReceiveInfo& r) { sessionOf(p, r).cars.pushMotion(p, r.monoNs); });
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include "packetBus.hpp"
+
+// Register the live views (input / position rings, static session info) as inline
+// subscribers so plots update on the ingest thread without waiting on any logger, and
+// hook their flashback handling onto g_sequenceTracker. Each packet lands in its own
+// session's stores (g_sessions), created on the session's first packet.
+void subscribeLiveViews(PacketBus& bus);
@@ -1,24 +1,71 @@
 #include "LiveTelemetry.hpp"
 #include "RingBuffer.hpp"
-#include <iostream>
-#include <thread>
-#include <chrono>
+#include "TieredHistory.hpp"
+#include "latencyHistogram.hpp"
 
-RingBuffer<LiveInputSample, 512> g_liveInputs;
-RingBuffer<LivePositionSample, 512> g_livePositions;
-StaticInfo g_staticInfo;
+LiveTelemetry::LiveTelemetry(const LiveHistoryConfig& config)
+    : inputs_(config.fullRateSamples()),
+      positions_(config.fullRateSamples()),
+      tiers_(new TieredHistory(config)),
+      rewinds_(64) {}
 
-size_t LiveTelemetry::copyHistory(LiveInputSample* out, size_t maxCount) {
-    return g_liveInputs.copy(out, maxCount);
+LiveTelemetry::~LiveTelemetry() = default;
+
+void LiveTelemetry::pushInput(const LiveInputSample& sample) {
+    inputs_.push(sample);
+    if (sample.receivedMonoNs) {
+        uint64_t now = monotonicNowNs();
+        g_latency[LATENCY_RING_PUSH].record(now > sample.receivedMonoNs ? now - sample.receivedMonoNs : 0);
+    }
+    tiers_->push(sample);
+}
+
+void LiveTelemetry::pushPosition(const LivePositionSample& sample) {
+    positions_.push(sample);
+}
+
+size_t LiveTelemetry::copyHistory(LiveInputSample* out, size_t maxCount) const {
+    return inputs_.copy(out, maxCount);
+}
+
+bool LiveTelemetry::peekLatest(LiveInputSample& out) const {
+    return inputs_.peekLatest(out);
+}
+
+size_t LiveTelemetry::copyPositionHistory(LivePositionSample* out, size_t maxCount) const {
+    return positions_.copy(out, maxCount);
+}
+bool LiveTelemetry::peekLatestPosition(LivePositionSample& out) const {
+    return positions_.peekLatest(out);
 }
 
-bool LiveTelemetry::peekLatest(LiveInputSample& out) {
-    return g_liveInputs.peekLatest(out);
+size_t LiveTelemetry::readSince(size_t& cursor, LiveInputSample* out, size_t maxCount, bool* overrun) const {
+    return inputs_.readSince(cursor, out, maxCount, overrun);
 }
 
-size_t LiveTelemetry::copyPositionHistory(LivePositionSample* out, size_t maxCount) {
-    return g_livePositions.copy(out, maxCount);
+size_t LiveTelemetry::readPositionsSince(size_t& cursor, LivePositionSample* out, size_t maxCount,
+                                         bool* overrun) const {
+    return positions_.readSince(cursor, out, maxCount, overrun);
 }
-bool LiveTelemetry::peekLatestPosition(LivePositionSample& out) {
-    return g_livePositions.peekLatest(out);
+
+size_t LiveTelemetry::readBucketsSince(HistoryTier tier, size_t& cursor, LiveInputBucket* out, size_t maxCount,
+                                       bool* overrun) const {
+    return tiers_->tier(tier).readSince(cursor, out, maxCount, overrun);
+}
+
+uint64_t LiveTelemetry::bucketPeriodMs(HistoryTier tier) {
+    return TieredHistory::periodMs(tier);
+}
+
+size_t LiveTelemetry::bucketCapacity(HistoryTier tier) const {
+    return tiers_->tier(tier).capacity();
+}
+
+void LiveTelemetry::rewind(uint64_t toMs) {
+    tiers_->rewind(toMs);
+    rewinds_.push({toMs, inputs_.written(), positions_.written()});
+}
+
+size_t LiveTelemetry::readRewindsSince(size_t& cursor, LiveRewind* out, size_t maxCount) const {
+    return rewinds_.readSince(cursor, out, maxCount);
 }
@@ -1,7 +1,9 @@
 #pragma once
 #include <cstdint>
+#include <memory>
 #include "RingBuffer.hpp"
 #include "StaticInfo.hpp"
+#include "sequenceTracker.hpp"
 
 struct LiveInputSample {
     // Basic inputs
@@ -17,6 +19,8 @@ struct LiveInputSample {
     int8_t gear;              // -1,0,1+
     uint8_t drs;              // 0/1
     uint8_t revLightsPercent; // 0-100
+
+    uint64_t receivedMonoNs;  // steady_clock time the packet reached the host (kernel stamp)
 };
 
 struct LivePositionSample {
@@ -24,19 +28,97 @@ struct LivePositionSample {
     float worldY;
     float worldZ;
     uint64_t timestampMs;
+    uint64_t receivedMonoNs;  // as LiveInputSample
+};
+
+// A flashback rewound session time to toMs. Samples pushed from inputIndex /
+// positionIndex on are the replayed timeline; everything a consumer holds that is
+// stamped after toMs and was pushed before those indices is stale. Indices are those of
+// the store that logged it: the player rings skip packets with no player car, so the
+// session's CarHistory logs its own (all its cars' rings advance together).
+struct LiveRewind {
+    uint64_t toMs;
+    size_t inputIndex;
+    size_t positionIndex;
+};
+
+// ===================== DOWNSAMPLED HISTORY =====================
+
+struct SeriesStats {
+    float min;
+    float max;
+    float mean;
+};
+
+// One fixed-period bucket of player inputs
+struct LiveInputBucket {
+    uint64_t startMs;     // session time the bucket starts at
+    uint32_t samples;     // raw samples aggregated
+    SeriesStats throttle;
+    SeriesStats brake;
+    SeriesStats steer;
+    SeriesStats speed;
+    SeriesStats engineRPM;
+};
+
+enum HistoryTier : uint8_t {
+    TIER_10HZ = 0,        // 100 ms buckets
+    TIER_1HZ = 1,         // 1 s buckets
+    NUM_HISTORY_TIERS
 };
 
-// The global ring buffer (size tunable)
-extern RingBuffer<LiveInputSample, 512> g_liveInputs;
-extern StaticInfo g_staticInfo;
-extern RingBuffer<LivePositionSample, 512> g_livePositions;
+// Live store capacities, applied to every session's stores when the session is created
+struct LiveHistoryConfig {
+    double fullRateSeconds = 60.0;        // raw samples, sized for the game's 60 Hz maximum send rate
+    double tier10HzSeconds = 30 * 60.0;   // 10 Hz min/max/mean buckets
+    double tier1HzSeconds = 4 * 60 * 60.0; // 1 Hz buckets, long enough for a full race
 
+    size_t fullRateSamples() const { return static_cast<size_t>(fullRateSeconds * 60.0); }
+};
+
+class TieredHistory;
+
+// The player's live stores for one session: full-rate input and position rings, the
+// downsampled tiers and the flashback log. Single writer (the ingest thread), any number
+// of readers, each with its own cursors.
 class LiveTelemetry {
 public:
-    static size_t copyHistory(LiveInputSample* out, size_t maxCount);
+    explicit LiveTelemetry(const LiveHistoryConfig& config = LiveHistoryConfig{});
+    ~LiveTelemetry();
+
+    LiveTelemetry(const LiveTelemetry&) = delete;
+    LiveTelemetry& operator=(const LiveTelemetry&) = delete;
+
+    // Writer side (ingest thread): full-rate ring plus the downsampled tiers
+    void pushInput(const LiveInputSample& sample);
+    void pushPosition(const LivePositionSample& sample);
+
+    size_t copyHistory(LiveInputSample* out, size_t maxCount) const;
     // Return the most recent sample if available (does not copy history)
-    static bool peekLatest(LiveInputSample& out);
+    bool peekLatest(LiveInputSample& out) const;
+
+    size_t copyPositionHistory(LivePositionSample* out, size_t maxCount) const;
+    bool peekLatestPosition(LivePositionSample& out) const;
+
+    // Only the samples pushed since `cursor` (see RingBuffer::readSince); one cursor per reader
+    size_t readSince(size_t& cursor, LiveInputSample* out, size_t maxCount, bool* overrun = nullptr) const;
+    size_t readPositionsSince(size_t& cursor, LivePositionSample* out, size_t maxCount,
+                              bool* overrun = nullptr) const;
+
+    // Closed buckets of a downsampled tier, oldest first
+    size_t readBucketsSince(HistoryTier tier, size_t& cursor, LiveInputBucket* out, size_t maxCount,
+                            bool* overrun = nullptr) const;
+    static uint64_t bucketPeriodMs(HistoryTier tier);
+    size_t bucketCapacity(HistoryTier tier) const;
+
+    // Flashback (ingest thread): drops the open downsampling buckets that hold rewound
+    // samples and records a LiveRewind for the readers
+    void rewind(uint64_t toMs);
+    size_t readRewindsSince(size_t& cursor, LiveRewind* out, size_t maxCount) const;
 
-    static size_t copyPositionHistory(LivePositionSample* out, size_t maxCount);
-    static bool peekLatestPosition(LivePositionSample& out);
+private:
+    RingBuffer<LiveInputSample> inputs_;
+    RingBuffer<LivePositionSample> positions_;
+    std::unique_ptr<TieredHistory> tiers_;
+    RingBuffer<LiveRewind> rewinds_;
 };
@@ -0,0 +1,200 @@
+#include "PlotLod.hpp"
+#include <algorithm>
+
+PlotLod::PlotLod(size_t series) : series_(std::min(series, kMaxSeries)) {}
+
+void PlotLod::clear() {
+    columns_ = 0;
+    count_ = 0;
+    first_.valid = before_.valid = after_.valid = last_.valid = false;
+    for (size_t s = 0; s < series_; ++s) {
+        lineX_[s].clear();
+        lineY_[s].clear();
+        bandMin_[s].clear();
+        bandMax_[s].clear();
+    }
+    bandX_.clear();
+}
+
+bool PlotLod::update(const double* xs, const double* const* ys, size_t count,
+                     double xMin, double xMax, int columns) {
+    if (count == 0) {
+        if (count_ == 0) return false;
+        clear();
+        return true;
+    }
+    if (columns < 1) columns = 1;
+
+    if (count_ == 0 || columns != columns_ || xMin != xMin_ || xMax != xMax_) {
+        xMin_ = xMin;
+        xMax_ = xMax;
+        columns_ = columns;
+        scale_ = xMax > xMin ? columns / (xMax - xMin) : 0.0;
+        rebuild(xs, ys, count);
+        emit();
+        return true;
+    }
+
+    // Same view. An append leaves the old newest point where it was; after a rewind it is
+    // gone or holds other values.
+    size_t k = static_cast<size_t>(std::upper_bound(xs, xs + count, last_.x) - xs);
+    bool appended = k > 0 && xs[k - 1] == last_.x;
+    for (size_t s = 0; appended && s < series_; ++s) {
+        appended = ys[s][k - 1] == last_.y[s];
+    }
+    // A full window drops its oldest points as it appends: only the first point moves, as
+    // long as everything dropped was left of the view
+    bool rolled = xs[0] != first_.x;
+    if (rolled && !(xs[0] < xMin_)) appended = false;
+
+    if (!appended) {
+        rebuild(xs, ys, count);
+        emit();
+        return true;
+    }
+    if (k == count && !rolled) return false;
+
+    take(first_, xs, ys, 0);
+    for (size_t i = k; i < count; ++i) {
+        if (xs[i] < xMin_) {
+            take(before_, xs, ys, i);
+        } else if (xs[i] <= xMax_) {
+            fold(xs, ys, i);
+        } else if (!after_.valid) {
+            take(after_, xs, ys, i);
+        }
+    }
+    take(last_, xs, ys, count - 1);
+    count_ = count;
+    emit();
+    return true;
+}
+
+void PlotLod::rebuild(const double* xs, const double* const* ys, size_t count) {
+    used_.assign(columns_, 0);
+    firstX_.resize(columns_);
+    // Output never exceeds two points per column plus four outside it: sized once per width
+    const size_t maxPoints = 2 * static_cast<size_t>(columns_) + 4;
+    for (size_t s = 0; s < series_; ++s) {
+        extremes_[s].resize(columns_);
+        lineX_[s].reserve(maxPoints);
+        lineY_[s].reserve(maxPoints);
+        bandMin_[s].reserve(maxPoints);
+        bandMax_[s].reserve(maxPoints);
+    }
+    bandX_.reserve(maxPoints);
+
+    size_t lo = static_cast<size_t>(std::lower_bound(xs, xs + count, xMin_) - xs);
+    size_t hi = static_cast<size_t>(std::upper_bound(xs, xs + count, xMax_) - xs);
+
+    // X is ascending, so each column's points are one run: reduce a run at a time, in locals
+    size_t i = lo;
+    while (i < hi) {
+        const int c = column(xs[i]);
+        // Scan to the column's right edge; column() only settles the rounding at the edge
+        const double edge = c + 1 < columns_ ? xMin_ + (c + 1) / scale_ : xMax_;
+        size_t end = i + 1;
+        while (end < hi && xs[end] < edge) ++end;
+        while (end < hi && column(xs[end]) == c) ++end;
+        while (end > i + 1 && column(xs[end - 1]) != c) --end;
+
+        used_[c] = 1;
+        firstX_[c] = xs[i];
+        for (size_t s = 0; s < series_; ++s) {
+            const double* y = ys[s];
+            size_t minAt = i, maxAt = i;
+            double minY = y[i], maxY = y[i];
+            for (size_t k = i + 1; k < end; ++k) {
+                if (y[k] < minY) { minY = y[k]; minAt = k; }
+                if (y[k] > maxY) { maxY = y[k]; maxAt = k; }
+            }
+            extremes_[s][c] = {xs[minAt], minY, xs[maxAt], maxY};
+        }
+        i = end;
+    }
+
+    before_.valid = lo > 0;
+    if (before_.valid) take(before_, xs, ys, lo - 1);
+    after_.valid = hi < count;
+    if (after_.valid) take(after_, xs, ys, hi);
+    take(first_, xs, ys, 0);
+    take(last_, xs, ys, count - 1);
+    count_ = count;
+    rebuilds_++;
+}
+
+void PlotLod::fold(const double* xs, const double* const* ys, size_t i) {
+    const double x = xs[i];
+    const int c = column(x);
+
+    if (!used_[c]) {
+        used_[c] = 1;
+        firstX_[c] = x;
+        for (size_t s = 0; s < series_; ++s) extremes_[s][c] = {x, ys[s][i], x, ys[s][i]};
+        return;
+    }
+    for (size_t s = 0; s < series_; ++s) {
+        Extreme& e = extremes_[s][c];
+        const double y = ys[s][i];
+        if (y < e.minY) { e.minX = x; e.minY = y; }
+        if (y > e.maxY) { e.maxX = x; e.maxY = y; }
+    }
+}
+
+void PlotLod::take(Point& point, const double* xs, const double* const* ys, size_t i) const {
+    point.valid = true;
+    point.x = xs[i];
+    for (size_t s = 0; s < series_; ++s) point.y[s] = ys[s][i];
+}
+
+void PlotLod::emitPoint(const Point& point) {
+    bandX_.push_back(point.x);
+    for (size_t s = 0; s < series_; ++s) {
+        lineX_[s].push_back(point.x);
+        lineY_[s].push_back(point.y[s]);
+        bandMin_[s].push_back(point.y[s]);
+        bandMax_[s].push_back(point.y[s]);
+    }
+}
+
+// Rebuild the drawn arrays from the columns: O(columns), whatever the series length
+void PlotLod::emit() {
+    for (size_t s = 0; s < series_; ++s) {
+        lineX_[s].clear();
+        lineY_[s].clear();
+        bandMin_[s].clear();
+        bandMax_[s].clear();
+    }
+    bandX_.clear();
+
+    if (first_.valid && first_.x < xMin_ && !(before_.valid && before_.x == first_.x)) emitPoint(first_);
+    if (before_.valid) emitPoint(before_);
+
+    for (int c = 0; c < columns_; ++c) {
+        if (!used_[c]) continue;
+        bandX_.push_back(firstX_[c]);
+        for (size_t s = 0; s < series_; ++s) {
+            const Extreme& e = extremes_[s][c];
+            bandMin_[s].push_back(e.minY);
+            bandMax_[s].push_back(e.maxY);
+            // Keep the column's two extremes in the order they happened
+            if (e.minX == e.maxX) {
+                lineX_[s].push_back(e.minX);
+                lineY_[s].push_back(e.minY);
+            } else if (e.minX < e.maxX) {
+                lineX_[s].push_back(e.minX);
+                lineY_[s].push_back(e.minY);
+                lineX_[s].push_back(e.maxX);
+                lineY_[s].push_back(e.maxY);
+            } else {
+                lineX_[s].push_back(e.maxX);
+                lineY_[s].push_back(e.maxY);
+                lineX_[s].push_back(e.minX);
+                lineY_[s].push_back(e.minY);
+            }
+        }
+    }
+
+    if (after_.valid) emitPoint(after_);
+    if (last_.valid && last_.x > xMax_ && !(after_.valid && after_.x == last_.x)) emitPoint(last_);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Level of detail for long plots. Reduces series that share one X array to the min and
+// max of each pixel column of the visible X range, so a plot costs about the same to draw
+// whether it spans 5 seconds or 90 minutes: at most two points per column, plus the points
+// just outside the view (lines still run to the edges) and the series' first and last
+// points (fitting the axis still sees all of it).
+//
+// The reduction is kept for the current view and width. Points appended while those stay
+// put are folded into the columns they land in; a zoom, pan or resize, or a series that
+// was rewound, rebuilds it in one pass over the visible points.
+class PlotLod {
+public:
+    static constexpr size_t kMaxSeries = 4;
+
+    explicit PlotLod(size_t series);
+
+    // xs ascending, ys[s] the values of series s. True if the reduction changed.
+    bool update(const double* xs, const double* const* ys, size_t count,
+                double xMin, double xMax, int columns);
+    void clear();
+
+    // Series s as a line: each column's min and max, in the order they occur
+    const double* lineX(size_t s) const { return lineX_[s].data(); }
+    const double* lineY(size_t s) const { return lineY_[s].data(); }
+    int lineSize(size_t s) const { return static_cast<int>(lineX_[s].size()); }
+
+    // Envelope for shaded bands: one X per column (its first point), and the min / max of
+    // series s there
+    const double* bandX() const { return bandX_.data(); }
+    const double* bandMin(size_t s) const { return bandMin_[s].data(); }
+    const double* bandMax(size_t s) const { return bandMax_[s].data(); }
+    int bandSize() const { return static_cast<int>(bandX_.size()); }
+
+    size_t rebuilds() const { return rebuilds_; }
+
+private:
+    struct Point {
+        bool valid = false;
+        double x = 0.0;
+        double y[kMaxSeries] = {};
+    };
+    struct Extreme {
+        double minX, minY, maxX, maxY;
+    };
+
+    int column(double x) const {
+        int c = static_cast<int>((x - xMin_) * scale_);
+        return c < 0 ? 0 : (c >= columns_ ? columns_ - 1 : c);
+    }
+    void rebuild(const double* xs, const double* const* ys, size_t count);
+    void fold(const double* xs, const double* const* ys, size_t i);
+    void take(Point& point, const double* xs, const double* const* ys, size_t i) const;
+    void emit();
+    void emitPoint(const Point& point);
+
+    size_t series_;
+
+    // Cached view
+    double xMin_ = 0.0;
+    double xMax_ = 0.0;
+    int columns_ = 0;
+    double scale_ = 0.0;   // columns per X unit
+
+    // Per column: whether any point landed there, its first X, then each series' extremes
+    std::vector<unsigned char> used_;
+    std::vector<double> firstX_;
+    std::vector<Extreme> extremes_[kMaxSeries];
+
+    Point first_;    // series' first point
+    Point before_;   // last point left of the view
+    Point after_;    // first point right of the view
+    Point last_;     // newest point, to tell an append from a rewrite
+    size_t count_ = 0;
+
+    std::vector<double> lineX_[kMaxSeries];
+    std::vector<double> lineY_[kMaxSeries];
+    std::vector<double> bandX_;
+    std::vector<double> bandMin_[kMaxSeries];
+    std::vector<double> bandMax_[kMaxSeries];
+    size_t rebuilds_ = 0;
+};
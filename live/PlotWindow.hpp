@@ -0,0 +1,118 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Contiguous sliding window over the newest `capacity` values, for ImPlot arrays fed
+// incrementally. Storage is twice the capacity; once it fills, the live window is moved
+// back to the front, so each push costs O(1) amortized instead of shifting every value.
+template<typename V>
+class PlotWindow {
+public:
+    explicit PlotWindow(size_t capacity) : capacity_(capacity) {
+        buf_.reserve(2 * capacity_);
+    }
+
+    void push(V value) {
+        if (capacity_ == 0) return;
+        if (buf_.size() == 2 * capacity_) {
+            buf_.erase(buf_.begin(), buf_.begin() + (buf_.size() - capacity_ + 1));
+            start_ = 0;
+        }
+        buf_.push_back(value);
+        if (buf_.size() - start_ > capacity_) ++start_;
+    }
+
+    void clear() {
+        buf_.clear();
+        start_ = 0;
+    }
+
+    // Keep only the oldest `size` values (drop the newest)
+    void truncate(size_t size) {
+        if (size < this->size()) buf_.resize(start_ + size);
+    }
+
+    // Empty the window and change how many values it keeps
+    void reset(size_t capacity) {
+        capacity_ = capacity;
+        buf_.clear();
+        buf_.shrink_to_fit();
+        buf_.reserve(2 * capacity_);
+        start_ = 0;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    const V* data() const { return buf_.data() + start_; }
+    size_t size() const { return buf_.size() - start_; }
+    bool empty() const { return size() == 0; }
+    V back() const { return buf_.back(); }
+    V operator[](size_t i) const { return buf_[start_ + i]; }
+    const V* begin() const { return data(); }
+    const V* end() const { return buf_.data() + buf_.size(); }
+
+private:
+    size_t capacity_;
+    size_t start_ = 0;
+    std::vector<V> buf_;
+};
+
+// Running max (Better = std::greater) or min (std::less) of the newest `window` values
+// pushed, O(1) amortized per push: a monotonic queue of the values that can still become
+// the extreme, in storage allocated once. Dropping the newest values (a flashback) can
+// bring back ones the queue discarded, so rebuild() from the plotted values after that.
+template<typename V, typename Better>
+class WindowExtreme {
+public:
+    explicit WindowExtreme(size_t window) : window_(window ? window : 1), entries_(window_) {}
+
+    void push(V value) {
+        ++serial_;
+        // Expired off the front of the window
+        while (count_ && entries_[head_].serial + window_ <= serial_) {
+            if (++head_ == window_) head_ = 0;
+            --count_;
+        }
+        // Never the extreme again: an older value no better than this one
+        while (count_ && !better_(entries_[back()].value, value)) --count_;
+
+        size_t at = head_ + count_;
+        if (at >= window_) at -= window_;
+        entries_[at] = {serial_, value};
+        ++count_;
+    }
+
+    void clear() {
+        head_ = 0;
+        count_ = 0;
+    }
+
+    template<typename Values>
+    void rebuild(const Values& values) {
+        clear();
+        for (V value : values) push(value);
+    }
+
+    bool empty() const { return count_ == 0; }
+    V value() const { return entries_[head_].value; }
+
+private:
+    struct Entry {
+        uint64_t serial;
+        V value;
+    };
+
+    size_t back() const {
+        size_t at = head_ + count_ - 1;
+        return at >= window_ ? at - window_ : at;
+    }
+
+    size_t window_;
+    std::vector<Entry> entries_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    uint64_t serial_ = 0;
+    Better better_;
+};
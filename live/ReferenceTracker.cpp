@@ -1,49 +1,87 @@
 #include "ReferenceTracker.hpp"
 #include "LiveTelemetry.hpp"
+#include "FrameAssembler.hpp"
 #include "StaticInfo.hpp"
 #include <iostream>
 #include <filesystem>
 
 namespace fs = std::filesystem;
 
-ReferenceTracker::ReferenceTracker() {
+ReferenceTracker::ReferenceTracker(const FrameAssembler* frames, const StaticInfo* info)
+    : trackId_(-1), assembler_(frames), info_(info) {
 }
 
 ReferenceTracker::~ReferenceTracker() {
 }
 
 void ReferenceTracker::update() {
-    LivePositionSample latest_sample;
-    LiveTelemetry::peekLatestPosition(latest_sample);
-    LiveInputSample inputHistory[512];
-    size_t inputCount = LiveTelemetry::copyHistory(inputHistory, 512);
+    // Whole frames, so the speed that starts recording and the position recorded come
+    // from the same m_overallFrameIdentifier
+    if (!assembler_) return;
+    if (frames_.empty()) frames_.resize(kFrameBatch);
+    for (;;) {
+        bool overrun = false;
+        size_t count = assembler_->readSince(frameCursor_, frames_.data(), frames_.size(), &overrun);
+        if (overrun) {
+            stationarySamples_ = 0;
+        }
+        if (count == 0) break;
 
-    if (!recordLap_){
-        if(inputCount < 50) {
-            return;
+        for (size_t i = 0; i < count; ++i) {
+            addFrame(frames_[i]);
         }
-        for (int i = 0; i < 50; ++i) {
-            if (inputHistory[inputCount - 1 - i].speed > 1e-3) {
-                return;
-            }
+    }
+}
+
+void ReferenceTracker::addFrame(const FrameSnapshot& frame) {
+    if (recordLap_ && frame.afterFlashback) {
+        // A flashback replays part of the lap: forget what was recorded from the rewind point
+        uint64_t toMs = static_cast<uint64_t>(frame.sessionTime * 1000);
+        size_t before = lapPositions_.size();
+        while (!lapTimesMs_.empty() && lapTimesMs_.back() >= toMs) {
+            lapTimesMs_.pop_back();
+            lapPositions_.pop_back();
+        }
+        std::cout << "Flashback: dropped " << before - lapPositions_.size() << " reference lap samples\n";
+    }
+
+    if (!frame.has(MOTION) || !frame.has(CAR_TELEMETRY)) {
+        return;   // partial frame, nothing to pair
+    }
+    const uint8_t car = frame.playerCarIndex;
+    if (car >= kMaxCars) {
+        return;   // spectating: no player car to record
+    }
+
+    if (!recordLap_) {
+        // Start once the car has sat still for 50 consecutive frames
+        stationarySamples_ = (frame.telemetry.m_carTelemetryData[car].m_speed > 0) ? 0 : stationarySamples_ + 1;
+        if (stationarySamples_ < 50) {
+            return;
         }
         recordLap_ = true;
         lapPositions_.clear();
-        std::cout << "Started recording reference lap for track " << g_staticInfo.track_id << "\n";
+        lapTimesMs_.clear();
+        std::cout << "Started recording reference lap for track " << (info_ ? info_->track_id : -1) << "\n";
+        return;
     }
-    
-    
-    lapPositions_.push_back({
-        latest_sample.worldX,
-        latest_sample.worldY,
-        latest_sample.worldZ
-    });
 
+    const CarMotionData& motion = frame.motion.m_carMotionData[car];
+    lapPositions_.push_back({motion.m_worldPositionX, motion.m_worldPositionY, motion.m_worldPositionZ});
+    lapTimesMs_.push_back(static_cast<uint64_t>(frame.sessionTime * 1000));
 }
 
-void ReferenceTracker::saveReferenceLap() {
+bool ReferenceTracker::saveReferenceLap() {
+    if (info_) trackId_ = info_->track_id;
+    if (trackId_ < 0) {
+        return false;   // never saw a session packet: no track to file it under
+    }
+    if (!recordLap_ || lapTimesMs_.empty() || lapTimesMs_.back() - lapTimesMs_.front() < kMinLapSeconds * 1000) {
+        std::cout << "Reference lap for track " << trackId_ << " not saved: " << lapPositions_.size()
+                  << " samples is not a lap\n";
+        return false;
+    }
     smoothReferenceLap(5);
-    trackId_ = g_staticInfo.track_id;
     fs::path dir("tools/track_calibration/track_paths");
     fs::create_directories(dir);  // ensure directory exists
 
@@ -51,11 +89,12 @@ void ReferenceTracker::saveReferenceLap() {
     std::ofstream ofs(filepath, std::ios::binary);
     if (!ofs) {
         std::cerr << "Failed to open " << filepath << " for writing\n";
-        return;
+        return false;
     }
 
     ofs.write(reinterpret_cast<const char*>(lapPositions_.data()), lapPositions_.size() * sizeof(Vec3));
     std::cout << "Saved reference lap (" << lapPositions_.size() << " samples) to " << filepath << "\n";
+    return true;
 }
 
 void ReferenceTracker::smoothReferenceLap(size_t window = 5) {
@@ -1,5 +1,7 @@
 #pragma once
 #include "LiveTelemetry.hpp"
+#include "FrameAssembler.hpp"
+#include "StaticInfo.hpp"
 #include <vector>
 #include <string>
 #include <fstream>
@@ -8,20 +10,41 @@ struct Vec3 {
     float x, y, z;
 };
 
+// Records the player's lap from one session's assembled frames. A tracker built without a
+// session can still load and smooth saved laps.
 class ReferenceTracker {
 public:
-    ReferenceTracker();
+    ReferenceTracker(const FrameAssembler* frames = nullptr, const StaticInfo* info = nullptr);
     ~ReferenceTracker();
 
-    void update();                      // append new samples from live telemetry
-    void saveReferenceLap();            // save to binary file
+    void update();                      // append new frames from the session's FrameAssembler
+    // Save to <track>_reference_lap.bin; false (and no file touched) without a track or a
+    // recorded lap of at least kMinLapSeconds, so an idle or spectated session never
+    // replaces a good reference
+    bool saveReferenceLap();
     bool loadReferenceLap(int trackId);            // load from binary file
     void smoothReferenceLap(size_t window); // smooth loaded lap positions
 
     const std::vector<Vec3>& getLapPositions() const { return lapPositions_; }
+    int trackId() const { return info_ ? info_->track_id : trackId_; }
+
+    static constexpr double kMinLapSeconds = 30.0;   // shorter than any track's lap
 
 private:
+    static constexpr size_t kFrameBatch = 16;
+
+    void addFrame(const FrameSnapshot& frame);
+
     std::vector<Vec3> lapPositions_;   // extracted positions for plotting
+    std::vector<uint64_t> lapTimesMs_; // session time of each recorded position
     int trackId_;
     bool recordLap_ = false;
+
+    const FrameAssembler* assembler_;
+    const StaticInfo* info_;
+
+    // Incremental read of the assembled frames
+    size_t frameCursor_ = 0;
+    std::vector<FrameSnapshot> frames_;
+    size_t stationarySamples_ = 0;     // consecutive frames with the car stopped
 };
@@ -1,37 +1,183 @@
 #pragma once
-#include <array>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
 
-template<typename T, size_t N>
+// Single-writer ring of the last `capacity` values (chosen at runtime). Every slot
+// carries a sequence number (seqlock): odd while the writer is inside it, 2 * (lap + 1)
+// once value number i with lap = i / capacity is complete. Readers copy a slot and
+// accept it only if the sequence was the expected even value before and after the copy,
+// so a snapshot never contains a torn or overwritten sample and the writer never waits
+// on a reader.
+//
+// Capacities are whatever the history config asks for, not powers of two, so nothing on
+// the hot paths divides: the writer steps its own slot and lap, and a read works out its
+// first slot once and steps from there. The writer's index sits on its own cache line,
+// and each reader's cursor is its own, so readers only ever share what they read.
+template<typename T>
 class RingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "RingBuffer values are copied with memcpy");
+
 public:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    explicit RingBuffer(size_t capacity = 0) {
+        reset(capacity);
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    // Reallocate and empty the ring. Only while no thread is pushing or reading.
+    void reset(size_t capacity) {
+        slotCount = capacity ? capacity : 1;
+        owned.reset(new Slot[slotCount]);
+        buffer = owned.get();
+        rewindWriter();
+    }
+
+    // Use `capacity` caller-owned slots instead (e.g. a slice of one arena shared by many
+    // rings). The storage must outlive the ring. Same threading rule as reset().
+    void attach(Slot* storage, size_t capacity) {
+        owned.reset();
+        buffer = storage;
+        slotCount = capacity;
+        for (size_t i = 0; i < slotCount; i++) {
+            buffer[i].seq.store(0, std::memory_order_relaxed);
+        }
+        rewindWriter();
+    }
+
+    size_t capacity() const { return slotCount; }
+
+    // Only one thread may push
     void push(const T& value) {
-        size_t idx = writeIndex.fetch_add(1);
-        buffer[idx % N] = value;
+        size_t w = writeIndex.load(std::memory_order_relaxed);
+        Slot& slot = buffer[writeSlot];
+
+        // The slot's sequence is known from the lap, so the writer never loads a line a
+        // reader may hold shared before taking it for the store
+        slot.seq.store(writeSeq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(slot.data, &value, sizeof(T));
+        slot.seq.store(writeSeq + 2, std::memory_order_release);
+
+        if (++writeSlot == slotCount) {
+            writeSlot = 0;
+            writeSeq += 2;
+        }
+
+        // Publish the index only once the slot is complete
+        writeIndex.store(w + 1, std::memory_order_release);
     }
 
-    // read snapshot (non-blocking)
+    // read snapshot (non-blocking). Copies up to maxCount of the newest values, oldest
+    // first; values the writer overwrote mid-copy are dropped from the front.
     size_t copy(T* out, size_t maxCount) const {
-        size_t w = writeIndex.load();
+        size_t w = writeIndex.load(std::memory_order_acquire);
         size_t count = (w > maxCount) ? maxCount : w;
+        if (count > slotCount) count = slotCount;
 
-        for (size_t i = 0; i < count; i++) {
-            out[i] = buffer[(w - count + i) % N];
+        size_t copied = 0;
+        Position at = position(w - count);
+        for (size_t i = 0; i < count; i++, advance(at)) {
+            if (readSlot(at, out[copied])) {
+                copied++;
+            } else {
+                // Lapped by the writer: everything older is gone too
+                copied = 0;
+            }
         }
-        return count;
+        return copied;
     }
 
     // Peek the most recent element without copying the whole buffer.
     // Returns false when the buffer is empty.
     bool peekLatest(T& out) const {
-        size_t w = writeIndex.load();
-        if (w == 0) return false;
-        size_t idx = (w - 1) % N;
-        out = buffer[idx];
-        return true;
+        for (;;) {
+            size_t w = writeIndex.load(std::memory_order_acquire);
+            if (w == 0) return false;
+            if (readSlot(position(w - 1), out)) return true;
+        }
     }
 
+    // Incremental read: copy the values pushed since `cursor` (at most maxCount, oldest
+    // first) and advance the cursor past them. Start with cursor = 0. When the reader fell
+    // more than capacity() behind, or was lapped mid-copy, the lost values are skipped and
+    // *overrun is set; the values returned are still consecutive.
+    size_t readSince(size_t& cursor, T* out, size_t maxCount, bool* overrun = nullptr) const {
+        size_t w = writeIndex.load(std::memory_order_acquire);
+        bool lost = false;
+        if (cursor > w) cursor = w;
+        if (w - cursor > slotCount) {
+            cursor = w - slotCount;
+            lost = true;
+        }
+
+        size_t end = (w - cursor > maxCount) ? cursor + maxCount : w;
+        size_t copied = 0;
+        Position at = position(cursor);
+        for (size_t i = cursor; i < end; i++, advance(at)) {
+            if (readSlot(at, out[copied])) {
+                copied++;
+            } else {
+                copied = 0;
+                lost = true;
+            }
+        }
+        cursor = end;
+        if (overrun) *overrun = lost;
+        return copied;
+    }
+
+    size_t written() const { return writeIndex.load(std::memory_order_acquire); }
+
 private:
-    std::array<T, N> buffer{};
-    std::atomic<size_t> writeIndex{0};
+    // Where value number i lives, and the sequence its slot has once it is complete
+    struct Position {
+        size_t slot;
+        uint64_t expected;
+    };
+
+    Position position(size_t index) const {
+        size_t lap = index / slotCount;
+        return {index - lap * slotCount, 2 * (static_cast<uint64_t>(lap) + 1)};
+    }
+
+    void advance(Position& at) const {
+        if (++at.slot == slotCount) {
+            at.slot = 0;
+            at.expected += 2;
+        }
+    }
+
+    void rewindWriter() {
+        writeSlot = 0;
+        writeSeq = 0;
+        writeIndex.store(0, std::memory_order_release);
+    }
+
+    // Copy the value at `at` if it is still intact in its slot
+    bool readSlot(const Position& at, T& out) const {
+        const Slot& slot = buffer[at.slot];
+        const uint64_t expected = at.expected;
+
+        if (slot.seq.load(std::memory_order_acquire) != expected) return false;
+        std::memcpy(&out, slot.data, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.seq.load(std::memory_order_relaxed) == expected;
+    }
+
+    size_t slotCount = 0;
+    Slot* buffer = nullptr;
+    std::unique_ptr<Slot[]> owned;
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    size_t writeSlot = 0;    // writer only: writeIndex % slotCount
+    uint64_t writeSeq = 0;   // writer only: sequence of a complete slot one lap back
 };
@@ -0,0 +1,200 @@
+#include "SessionRegistry.hpp"
+#include <iostream>
+
+SessionRegistry g_sessions;
+
+static constexpr uint64_t kEvictionCheckNs = 1000000000ull;   // idle sessions are looked for once a second
+
+LiveSession::LiveSession(const LiveHistoryConfig& config)
+    : player(config), reference(&frames, &info) {
+    cars.configure(config);
+}
+
+void LiveSession::rewind(const FlashbackEvent& event) {
+    uint64_t toMs = static_cast<uint64_t>(event.toSessionTime * 1000);
+    cars.rewind(toMs);
+    player.rewind(toMs);
+}
+
+SessionRegistry::~SessionRegistry() {
+    stopPreparing();
+}
+
+void SessionRegistry::stopPreparing() {
+    {
+        std::lock_guard<std::mutex> lock(spareMutex_);
+        stopping_ = true;
+    }
+    spareWanted_.notify_all();
+    if (preparer_.joinable()) preparer_.join();
+}
+
+void SessionRegistry::configure(const SessionRegistryConfig& config) {
+    stopPreparing();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_ = config;
+        if (config_.maxSessions == 0) config_.maxSessions = 1;
+        sessions_.clear();
+        stats_.active.store(0, std::memory_order_relaxed);
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+
+    // The first spares are built here, so the first sessions never wait
+    std::lock_guard<std::mutex> lock(spareMutex_);
+    spares_.clear();
+    while (spares_.size() < config_.spareSessions) {
+        spares_.emplace_back(new LiveSession(config_.history));
+    }
+    stopping_ = false;
+    preparer_ = std::thread(&SessionRegistry::prepareSpares, this);
+}
+
+void SessionRegistry::prepareSpares() {
+    std::unique_lock<std::mutex> lock(spareMutex_);
+    for (;;) {
+        spareWanted_.wait(lock, [this]() { return stopping_ || spares_.size() < config_.spareSessions; });
+        if (stopping_) return;
+
+        lock.unlock();
+        std::unique_ptr<LiveSession> spare(new LiveSession(config_.history));
+        lock.lock();
+        spares_.push_back(std::move(spare));
+    }
+}
+
+// Per listener thread: the session its previous packet went to, valid while the registry
+// generation it was found at is current. Every add / remove bumps the generation, so a
+// cached session is never one that was evicted.
+struct RouteCache {
+    const SessionRegistry* registry = nullptr;
+    uint64_t generation = 0;
+    std::shared_ptr<LiveSession> session;
+};
+static thread_local RouteCache t_route;
+
+LiveSession& SessionRegistry::route(const SessionKey& key, uint64_t receivedMonoNs) {
+    uint64_t checkNs = nextEvictionCheckNs_.load(std::memory_order_relaxed);
+    if (receivedMonoNs >= checkNs &&
+        nextEvictionCheckNs_.compare_exchange_strong(checkNs, receivedMonoNs + kEvictionCheckNs,
+                                                     std::memory_order_relaxed)) {
+        evictIdle(receivedMonoNs);
+    }
+
+    RouteCache& cache = t_route;
+    LiveSession* session = cache.session.get();
+    if (!session || cache.registry != this || session->key() != key ||
+        cache.generation != generation_.load(std::memory_order_acquire)) {
+        cache.session = lookup(key, receivedMonoNs, cache.generation);
+        cache.registry = this;
+        session = cache.session.get();
+    }
+
+    session->lastPacketNs.store(receivedMonoNs, std::memory_order_relaxed);
+    return *session;
+}
+
+// The session for key, created if there is none; `generation` is the registry generation
+// it was found or added at
+std::shared_ptr<LiveSession> SessionRegistry::lookup(const SessionKey& key, uint64_t nowNs, uint64_t& generation) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const std::shared_ptr<LiveSession>& candidate : sessions_) {
+            if (candidate->key() == key) {
+                generation = generation_.load(std::memory_order_relaxed);
+                return candidate;
+            }
+        }
+    }
+    // Not under mutex_: building stores inline takes a while, and readers need the lock
+    return create(key, nowNs, generation);
+}
+
+std::shared_ptr<LiveSession> SessionRegistry::create(const SessionKey& key, uint64_t nowNs, uint64_t& generation) {
+    std::unique_ptr<LiveSession> spare;
+    {
+        std::lock_guard<std::mutex> lock(spareMutex_);
+        if (!spares_.empty()) {
+            spare = std::move(spares_.back());
+            spares_.pop_back();
+        }
+    }
+    spareWanted_.notify_one();
+    if (!spare) {
+        // More new sessions at once than spares: build this one here and stall ingest
+        spare.reset(new LiveSession(config_.history));
+        stats_.builtInline.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<LiveSession> session(spare.release());
+    session->key_ = key;
+    session->createdNs = nowNs;
+    session->lastPacketNs.store(nowNs, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sessions_.size() >= config_.maxSessions) {
+        // Full: make room by dropping whichever session has been quiet longest
+        size_t idlest = 0;
+        for (size_t i = 1; i < sessions_.size(); ++i) {
+            if (sessions_[i]->lastPacketNs.load(std::memory_order_relaxed) <
+                sessions_[idlest]->lastPacketNs.load(std::memory_order_relaxed)) {
+                idlest = i;
+            }
+        }
+        erase(idlest);
+    }
+    sessions_.push_back(session);
+    stats_.created.fetch_add(1, std::memory_order_relaxed);
+    stats_.active.store(sessions_.size(), std::memory_order_relaxed);
+    generation = generation_.fetch_add(1, std::memory_order_release) + 1;
+    std::cout << "Session " << describeSession(key) << " started (" << sessions_.size() << " live, "
+              << session->cars.arenaBytes() / (1024 * 1024) << " MB per-car history)\n";
+    return session;
+}
+
+static bool idleFor(const LiveSession& session, uint64_t nowNs, uint64_t timeoutNs) {
+    uint64_t last = session.lastPacketNs.load(std::memory_order_relaxed);
+    return nowNs > last && nowNs - last > timeoutNs;
+}
+
+// Once a second, on whichever listener thread gets there first
+void SessionRegistry::evictIdle(uint64_t nowNs) {
+    const uint64_t timeoutNs = static_cast<uint64_t>(config_.idleTimeoutSeconds * 1e9);
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool idle = false;
+    for (size_t i = sessions_.size(); i-- > 0;) {
+        if (idleFor(*sessions_[i], nowNs, timeoutNs)) {
+            erase(i);
+            idle = true;
+        }
+    }
+    if (!idle) return;
+    stats_.active.store(sessions_.size(), std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_release);
+}
+
+// mutex_ held. Readers holding the session keep it alive.
+void SessionRegistry::erase(size_t index) {
+    std::cout << "Session " << describeSession(sessions_[index]->key()) << " evicted after "
+              << sessions_[index]->packets.load(std::memory_order_relaxed) << " packets\n";
+    sessions_.erase(sessions_.begin() + index);
+    stats_.evicted.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<std::shared_ptr<LiveSession>> SessionRegistry::sessions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_;
+}
+
+std::shared_ptr<LiveSession> SessionRegistry::find(const SessionKey& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const std::shared_ptr<LiveSession>& session : sessions_) {
+        if (session->key() == key) return session;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<LiveSession> SessionRegistry::newest() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.empty() ? nullptr : sessions_.back();
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include "sessionKey.hpp"
+#include "LiveTelemetry.hpp"
+#include "CarHistory.hpp"
+#include "FieldState.hpp"
+#include "FrameAssembler.hpp"
+#include "StaticInfo.hpp"
+#include "ReferenceTracker.hpp"
+
+// Everything live about one session from one rig. The stores have one writer at a time,
+// the listener thread holding the publish lock of the session's stream; readers hold a
+// shared_ptr, so a session evicted from the registry stays readable until the last reader
+// lets go of it.
+class LiveSession {
+public:
+    explicit LiveSession(const LiveHistoryConfig& config);
+
+    LiveSession(const LiveSession&) = delete;
+    LiveSession& operator=(const LiveSession&) = delete;
+
+    const SessionKey& key() const { return key_; }
+
+    // Flashback in this session (listener thread)
+    void rewind(const FlashbackEvent& event);
+
+    LiveTelemetry player;    // the player's inputs, positions and downsampled tiers
+    CarHistory cars;         // every car's inputs and positions
+    FieldState field;        // latest whole-field frame
+    FrameAssembler frames;   // per-frame packets joined by overall frame id
+    StaticInfo info;
+
+    // Reader side, analysis thread only (TelemetryAnalysis): records a reference lap in
+    // --reference-lap mode. TelemetryAnalysis::stop() saves it once that thread has joined.
+    ReferenceTracker reference;
+
+    std::atomic<uint64_t> packets{0};
+    std::atomic<uint64_t> lastPacketNs{0};   // steady clock receive time of the newest packet
+    uint64_t createdNs = 0;
+
+private:
+    friend class SessionRegistry;   // keys a prepared session when its first packet arrives
+
+    SessionKey key_ = {};
+};
+
+struct SessionRegistryConfig {
+    LiveHistoryConfig history;          // sizes every session's stores
+    size_t maxSessions = 8;             // live sessions kept at once (~60 MB each at the defaults)
+    size_t spareSessions = 2;           // stores built ahead of time, ready for the next new sessions
+    double idleTimeoutSeconds = 600;    // evict a session that has sent nothing for this long
+};
+
+struct SessionRegistryStats {
+    std::atomic<uint64_t> created{0};
+    std::atomic<uint64_t> evicted{0};   // idle, or the longest idle when a new one needed the slot
+    std::atomic<uint64_t> active{0};
+    std::atomic<uint64_t> builtInline{0};   // no spare was ready: the ingest thread built the stores
+};
+
+// Live sessions keyed by (source IP, m_sessionUID), so several games sending to one host
+// never share a buffer. Listener threads create sessions on their first packet and evict
+// idle ones; readers list or look them up from any thread.
+//
+// A session's stores are tens of MB and take a while to build, far longer than the
+// ingest thread can stall. A background thread keeps spareSessions of them built, and a
+// new session just takes one.
+class SessionRegistry {
+public:
+    SessionRegistry() = default;
+    ~SessionRegistry();
+
+    void configure(const SessionRegistryConfig& config);   // before ingest starts
+
+    // Listener threads: the session a packet belongs to, created on first sight. Lock-free
+    // while a thread's packets keep going to the session its previous one went to and no
+    // session was added or removed since. One key is never routed on two threads at once
+    // (handleDatagram() serialises each stream).
+    LiveSession& route(const SessionKey& key, uint64_t receivedMonoNs);
+    LiveSession& route(const PacketHeader& header, const ReceiveInfo& received) {
+        return route(SessionKey::of(header, received), received.monoNs);
+    }
+
+    // Any thread
+    std::vector<std::shared_ptr<LiveSession>> sessions() const;   // oldest first
+    std::shared_ptr<LiveSession> find(const SessionKey& key) const;
+    std::shared_ptr<LiveSession> newest() const;                  // most recently created
+
+    uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+    const SessionRegistryStats& stats() const { return stats_; }
+    const SessionRegistryConfig& config() const { return config_; }
+
+private:
+    std::shared_ptr<LiveSession> lookup(const SessionKey& key, uint64_t nowNs, uint64_t& generation);
+    std::shared_ptr<LiveSession> create(const SessionKey& key, uint64_t nowNs, uint64_t& generation);
+    void evictIdle(uint64_t nowNs);
+    void erase(size_t index);
+    void stopPreparing();
+    void prepareSpares();   // background thread
+
+    SessionRegistryConfig config_;
+
+    std::vector<std::shared_ptr<LiveSession>> sessions_;   // under mutex_
+    mutable std::mutex mutex_;
+    std::atomic<uint64_t> generation_{0};   // bumped, under mutex_, whenever a session is added or removed
+
+    std::atomic<uint64_t> nextEvictionCheckNs_{0};
+
+    std::vector<std::unique_ptr<LiveSession>> spares_;   // under spareMutex_
+    std::mutex spareMutex_;
+    std::condition_variable spareWanted_;
+    std::thread preparer_;
+    bool stopping_ = false;
+
+    SessionRegistryStats stats_;
+};
+
+extern SessionRegistry g_sessions;
@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Hands immutable snapshots from one writer thread to one reader thread. Double buffered
+// with a spare in between: the writer fills its back buffer and swaps it into the middle
+// slot, the reader swaps the middle slot for its front buffer when a newer one is there.
+// Neither side waits on the other or ever sees a buffer the other is using; the reader
+// always gets the newest snapshot, and one published while the last was still unread
+// replaces it. No allocation: T is built three times, up front, and reused.
+template<typename T>
+class SnapshotBuffer {
+public:
+    // Writer side: fill back(), then publish() it. Returns true when the snapshot it
+    // replaced was never taken; that snapshot is the new back(), so the writer can still
+    // carry over what the reader missed before overwriting it.
+    T& back() { return slots_[back_]; }
+
+    bool publish() {
+        uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel);
+        back_ = previous & kIndex;
+        return (previous & kFresh) != 0;
+    }
+
+    // Reader side: the newest published snapshot, nullptr before the first. Stays valid
+    // and unchanged until the reader's next call.
+    const T* latest() {
+        if (middle_.load(std::memory_order_acquire) & kFresh) {
+            uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+            front_ = previous & kIndex;
+            haveFront_ = true;
+        }
+        return haveFront_ ? &slots_[front_] : nullptr;
+    }
+
+private:
+    static constexpr uint8_t kIndex = 0x3;
+    static constexpr uint8_t kFresh = 0x4;   // middle slot holds a snapshot not taken yet
+
+    std::array<T, 3> slots_;
+    uint8_t back_ = 0;                       // writer's
+    alignas(64) std::atomic<uint8_t> middle_{1};
+    alignas(64) uint8_t front_ = 2;          // reader's
+    bool haveFront_ = false;
+};
@@ -0,0 +1,350 @@
+#include "TelemetryAnalysis.hpp"
+#include "FramePacer.hpp"
+#include "latencyHistogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+TelemetryAnalysis g_analysis;
+
+TelemetryAnalysis::~TelemetryAnalysis() {
+    stop();
+}
+
+void TelemetryAnalysis::start(const AnalysisConfig& config) {
+    if (running_.load()) return;
+    config_ = config;
+    pendingRewinds_.reserve(16);
+    running_.store(true);
+    thread_ = std::thread([this]() { run(); });
+    std::cout << "Analysis thread at " << config_.rateHz << " Hz\n";
+}
+
+void TelemetryAnalysis::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+
+    // The thread is gone: record what arrived since its last pass, then save
+    if (config_.referenceLaps) {
+        updateReferenceLaps();
+        for (const std::shared_ptr<LiveSession>& session : referenceSessions_) {
+            saveReferenceLap(*session);
+        }
+    }
+}
+
+uint64_t TelemetryAnalysis::select(std::shared_ptr<LiveSession> session, int focusCar) {
+    std::lock_guard<std::mutex> lock(selectMutex_);
+    requestedSession_ = std::move(session);
+    requestedCar_ = focusCar;
+    uint64_t id = requested_.load(std::memory_order_relaxed) + 1;
+    requested_.store(id, std::memory_order_release);
+    return id;
+}
+
+void TelemetryAnalysis::run() {
+    FramePacer pacer(config_.rateHz);
+    while (running_.load(std::memory_order_relaxed)) {
+        uint64_t startNs = monotonicNowNs();
+
+        takeSelection();
+        updateInputs();
+        if (inputsChanged_) publishInputs();
+        updateTrackMap();
+        if (config_.referenceLaps) updateReferenceLaps();
+
+        stats_.busyNs.fetch_add(monotonicNowNs() - startNs, std::memory_order_relaxed);
+        stats_.ticks.fetch_add(1, std::memory_order_relaxed);
+        pacer.wait();
+        stats_.late.store(pacer.late(), std::memory_order_relaxed);
+    }
+}
+
+// A new pick starts the windows over; only locks when select() was called since
+void TelemetryAnalysis::takeSelection() {
+    uint64_t requested = requested_.load(std::memory_order_acquire);
+    if (requested == selection_) return;
+
+    std::lock_guard<std::mutex> lock(selectMutex_);
+    selection_ = requested_.load(std::memory_order_relaxed);
+    session_ = requestedSession_;
+    focusCar_ = requestedCar_;
+    inputCursor_ = 0;
+    rewindCursor_ = 0;
+    pendingRewinds_.clear();
+    clearInputs();
+    inputs_.back().receivedCount = 0;
+    inputsChanged_ = true;   // publish, even empty, so the render thread sees the switch
+}
+
+void TelemetryAnalysis::clearInputs() {
+    throttle_.clear();
+    brake_.clear();
+    steer_.clear();
+    time_.clear();
+    drs_.clear();
+    gear_.clear();
+    throttleMax_.clear();
+    brakeMax_.clear();
+    steerMax_.clear();
+    steerMin_.clear();
+}
+
+// After a rewind dropped the newest samples: values the running extremes had discarded
+// may be back in front
+void TelemetryAnalysis::rebuildExtremes() {
+    throttleMax_.rebuild(throttle_);
+    brakeMax_.rebuild(brake_);
+    steerMax_.rebuild(steer_);
+    steerMin_.rebuild(steer_);
+}
+
+// Drop the plotted samples a flashback replaced, once the stream reaches it
+void TelemetryAnalysis::applyRewinds(size_t inputIndex) {
+    size_t applied = 0;
+    while (applied < pendingRewinds_.size() && pendingRewinds_[applied].inputIndex <= inputIndex) {
+        double toSeconds = pendingRewinds_[applied].toMs / 1000.0;
+        size_t keep = time_.size();
+        while (keep > 0 && time_[keep - 1] > toSeconds) keep--;
+        throttle_.truncate(keep);
+        brake_.truncate(keep);
+        steer_.truncate(keep);
+        time_.truncate(keep);
+        drs_.truncate(keep);
+        gear_.truncate(keep);
+        applied++;
+    }
+    if (applied == 0) return;
+    pendingRewinds_.erase(pendingRewinds_.begin(), pendingRewinds_.begin() + applied);
+    rebuildExtremes();
+    inputsChanged_ = true;
+}
+
+void TelemetryAnalysis::updateInputs() {
+    if (!session_) return;
+
+    // Only the samples that arrived since the last pass
+    LiveInputSample samples[kMaxSamples];
+    bool overrun = false;
+    size_t count = focusCar_ < 0
+        ? session_->player.readSince(inputCursor_, samples, kMaxSamples, &overrun)
+        : session_->cars.readSince(static_cast<size_t>(focusCar_), inputCursor_, samples, kMaxSamples, &overrun);
+
+    // Read after the samples: a rewind is recorded before the first sample it applies
+    // to, so every rewind inside this batch is already visible. Its indices are those of
+    // the store the samples came from.
+    LiveRewind rewinds[16];
+    size_t rewindCount;
+    while ((rewindCount = focusCar_ < 0
+                ? session_->player.readRewindsSince(rewindCursor_, rewinds, 16)
+                : session_->cars.readRewindsSince(rewindCursor_, rewinds, 16)) > 0) {
+        pendingRewinds_.insert(pendingRewinds_.end(), rewinds, rewinds + rewindCount);
+    }
+
+    if (overrun) {
+        // Fell more than a buffer behind: the window would have a hole, start it over
+        clearInputs();
+    }
+    if (count > 0) inputsChanged_ = true;
+
+    InputsSnapshot& next = inputs_.back();
+    const size_t firstIndex = inputCursor_ - count;
+    for (size_t i = 0; i < count; i++) {
+        applyRewinds(firstIndex + i);
+        throttle_.push(samples[i].throttle);
+        brake_.push(samples[i].brake);
+        steer_.push(samples[i].steer);
+        throttleMax_.push(samples[i].throttle);
+        brakeMax_.push(samples[i].brake);
+        steerMax_.push(samples[i].steer);
+        steerMin_.push(samples[i].steer);
+        drs_.push(static_cast<int>(samples[i].drs));
+        gear_.push(static_cast<int>(samples[i].gear));
+        time_.push(samples[i].timestampMs / 1000.0);  // Convert ms to seconds
+        if (samples[i].receivedMonoNs && next.receivedCount < InputsSnapshot::kMaxReceived) {
+            next.receivedNs[next.receivedCount++] = samples[i].receivedMonoNs;
+        }
+    }
+    applyRewinds(inputCursor_);
+}
+
+// Fill the back buffer from the windows and hand it to the render thread
+void TelemetryAnalysis::publishInputs() {
+    InputsSnapshot& next = inputs_.back();
+    next.selection = selection_;
+    next.sequence = ++sequence_;
+
+    const size_t n = time_.size();
+    next.count = n;
+    const double tEnd = n ? time_.back() : 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        next.secondsAgo[i] = time_[i] - tEnd;   // newest is 0, older negative
+        next.throttle[i] = throttle_[i];
+        next.brake[i] = brake_[i];
+        next.steer[i] = steer_[i];
+    }
+
+    // Gear changes: where the gear differs from the previous sample
+    next.gearUps = 0;
+    next.gearDowns = 0;
+    for (size_t i = 1; i < n; ++i) {
+        if (gear_[i] > gear_[i - 1]) next.gearUpX[next.gearUps++] = next.secondsAgo[i];
+        else if (gear_[i] < gear_[i - 1]) next.gearDownX[next.gearDowns++] = next.secondsAgo[i];
+    }
+
+    // Contiguous DRS-open ranges
+    next.drsSpans = 0;
+    size_t idx = 0;
+    while (idx < n) {
+        while (idx < n && drs_[idx] == 0) ++idx;
+        if (idx >= n) break;
+        size_t start = idx;
+        while (idx < n && drs_[idx] != 0) ++idx;
+        next.drsStartX[next.drsSpans] = next.secondsAgo[start];
+        next.drsEndX[next.drsSpans] = next.secondsAgo[idx - 1];
+        next.drsSpans++;
+    }
+
+    if (!throttleMax_.empty()) {
+        next.throttleMax = throttleMax_.value();
+        next.brakeMax = brakeMax_.value();
+        next.steerMax = steerMax_.value();
+        next.steerMin = steerMin_.value();
+    }
+
+    next.builtNs = monotonicNowNs();
+    if (inputs_.publish()) {
+        // The render thread skipped the last one: its samples ride along in the next, so
+        // their render latency is still recorded. back() is that snapshot now.
+        stats_.replaced.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        inputs_.back().receivedCount = 0;
+    }
+    stats_.published.fetch_add(1, std::memory_order_relaxed);
+    inputsChanged_ = false;
+}
+
+bool TelemetryAnalysis::takeTrackMap(std::shared_ptr<const TrackMap>& map, uint64_t& version) {
+    if (trackMapVersion_.load(std::memory_order_acquire) == version) return false;
+    std::lock_guard<std::mutex> lock(trackMapMutex_);
+    map = trackMap_;
+    version = trackMapVersion_.load(std::memory_order_relaxed);
+    return true;
+}
+
+// Ramer-Douglas-Peucker on the top-down X / Z path: keeps the points that bend the line by
+// more than `tolerance`, so straights collapse to their ends and corners keep their shape
+static void decimatePath(const std::vector<Vec3>& path, float tolerance, std::vector<float>& xs,
+                         std::vector<float>& zs) {
+    const size_t n = path.size();
+    std::vector<unsigned char> keep(n, 0);
+    keep[0] = keep[n - 1] = 1;
+
+    std::vector<std::pair<size_t, size_t>> spans;
+    spans.push_back({0, n - 1});
+    while (!spans.empty()) {
+        size_t a = spans.back().first, b = spans.back().second;
+        spans.pop_back();
+        if (b <= a + 1) continue;
+
+        const float dx = path[b].x - path[a].x, dz = path[b].z - path[a].z;
+        const float length = std::sqrt(dx * dx + dz * dz);
+        float worst = -1.0f;
+        size_t worstAt = a;
+        for (size_t i = a + 1; i < b; ++i) {
+            const float px = path[i].x - path[a].x, pz = path[i].z - path[a].z;
+            // Distance to the chord; to point a when the chord has no length (a closed lap)
+            const float d = length > 0.0f ? std::fabs(px * dz - pz * dx) / length : std::sqrt(px * px + pz * pz);
+            if (d > worst) {
+                worst = d;
+                worstAt = i;
+            }
+        }
+        if (worst > tolerance) {
+            keep[worstAt] = 1;
+            spans.push_back({a, worstAt});
+            spans.push_back({worstAt, b});
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        if (!keep[i]) continue;
+        xs.push_back(path[i].x);
+        zs.push_back(path[i].z);
+    }
+}
+
+// The disk read, bounds and decimation happen here, once per track, instead of in the frame
+void TelemetryAnalysis::updateTrackMap() {
+    if (!session_) return;
+    const int trackId = session_->info.track_id;
+    if (trackId == mapTrackId_) return;
+    mapTrackId_ = trackId;
+    if (trackId < 0) return;
+
+    ReferenceTracker tracker;
+    if (!tracker.loadReferenceLap(trackId)) return;   // looked for again only on the next track
+    const std::vector<Vec3>& path = tracker.getLapPositions();
+    if (path.size() < 2) return;
+
+    std::shared_ptr<TrackMap> map = std::make_shared<TrackMap>();
+    map->trackId = trackId;
+    map->referencePoints = path.size();
+
+    float minX = path[0].x, maxX = path[0].x;
+    float minZ = path[0].z, maxZ = path[0].z;
+    for (const Vec3& p : path) {
+        minX = std::min(minX, p.x);
+        maxX = std::max(maxX, p.x);
+        minZ = std::min(minZ, p.z);
+        maxZ = std::max(maxZ, p.z);
+    }
+    // 5% margin around the track
+    const float xMargin = (maxX - minX) * 0.05f;
+    const float zMargin = (maxZ - minZ) * 0.05f;
+    map->minX = minX - xMargin;
+    map->maxX = maxX + xMargin;
+    map->minZ = minZ - zMargin;
+    map->maxZ = maxZ + zMargin;
+
+    // The map is a few hundred pixels across: a tenth of a pixel of error is invisible
+    const float extent = std::max(maxX - minX, maxZ - minZ);
+    decimatePath(path, extent / 3000.0f, map->xs, map->zs);
+
+    std::cout << "Track map for track " << trackId << ": " << map->referencePoints << " reference points, "
+              << map->xs.size() << " drawn\n";
+    std::lock_guard<std::mutex> lock(trackMapMutex_);
+    trackMap_ = std::move(map);
+    trackMapVersion_.fetch_add(1, std::memory_order_release);
+}
+
+// The first session to finish a lap on a track saves it; later ones (a second rig, a
+// spectator) leave that file alone for the rest of the run
+void TelemetryAnalysis::saveReferenceLap(LiveSession& session) {
+    const int trackId = session.reference.trackId();
+    if (std::find(savedTracks_.begin(), savedTracks_.end(), trackId) != savedTracks_.end()) {
+        std::cout << "Reference lap for track " << trackId << " already saved this run: "
+                  << describeSession(session.key()) << " not saved\n";
+        return;
+    }
+    if (session.reference.saveReferenceLap()) savedTracks_.push_back(trackId);
+}
+
+// --reference-lap: every live session records its own lap; each is saved when the session
+// ends (and the rest in stop())
+void TelemetryAnalysis::updateReferenceLaps() {
+    if (g_sessions.generation() != referenceGeneration_) {
+        referenceGeneration_ = g_sessions.generation();
+        std::vector<std::shared_ptr<LiveSession>> live = g_sessions.sessions();
+        for (const std::shared_ptr<LiveSession>& session : referenceSessions_) {
+            if (std::find(live.begin(), live.end(), session) == live.end()) {
+                session->reference.update();
+                saveReferenceLap(*session);
+            }
+        }
+        referenceSessions_ = std::move(live);
+    }
+    for (const std::shared_ptr<LiveSession>& session : referenceSessions_) {
+        session->reference.update();
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "PlotWindow.hpp"
+#include "SessionRegistry.hpp"
+#include "SnapshotBuffer.hpp"
+
+// Driver Inputs contents for one session / car, built by the analysis thread. Published
+// whole and never changed after, so the render thread only has to draw it.
+struct InputsSnapshot {
+    static constexpr size_t kMaxSamples = 512;
+    static constexpr size_t kMaxReceived = 4 * kMaxSamples;
+
+    uint64_t selection = 0;   // TelemetryAnalysis::select() it follows
+    uint64_t sequence = 0;    // counts published snapshots from 1
+    uint64_t builtNs = 0;     // steady_clock time it was published
+
+    // Plotted window, oldest first; X is seconds before the newest sample (<= 0)
+    size_t count = 0;
+    std::array<double, kMaxSamples> secondsAgo;
+    std::array<double, kMaxSamples> throttle;
+    std::array<double, kMaxSamples> brake;
+    std::array<double, kMaxSamples> steer;
+
+    // Derived from the window: gear change markers, DRS-open spans (as X values) and extremes
+    size_t gearUps = 0;
+    size_t gearDowns = 0;
+    std::array<double, kMaxSamples> gearUpX;
+    std::array<double, kMaxSamples> gearDownX;
+    size_t drsSpans = 0;
+    std::array<double, kMaxSamples / 2 + 1> drsStartX;
+    std::array<double, kMaxSamples / 2 + 1> drsEndX;
+    double throttleMax = 0.0;
+    double brakeMax = 0.0;
+    double steerMin = 0.0;
+    double steerMax = 0.0;
+
+    // Receive times of the samples new in this snapshot (plus those of any snapshot it
+    // replaced unread), recorded as render latency once it is on screen
+    size_t receivedCount = 0;
+    std::array<uint64_t, kMaxReceived> receivedNs;
+};
+
+// Mini map geometry for one track, built by the analysis thread from the saved reference lap
+// once per track_id. Immutable once published; the render thread only adds the car marker.
+struct TrackMap {
+    int trackId = -1;
+    size_t referencePoints = 0;   // reference lap samples before decimation
+    std::vector<float> xs;        // top-down (X / Z) polyline, decimated to the map's resolution
+    std::vector<float> zs;
+    double minX = 0.0;            // axis limits, margin included
+    double maxX = 0.0;
+    double minZ = 0.0;
+    double maxZ = 0.0;
+};
+
+struct AnalysisConfig {
+    double rateHz = 120.0;        // analysis passes per second
+    bool referenceLaps = false;   // --reference-lap: record every live session's lap
+};
+
+struct AnalysisStats {
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<uint64_t> late{0};        // passes that overran a whole period
+    std::atomic<uint64_t> busyNs{0};      // time spent working, not waiting
+    std::atomic<uint64_t> published{0};   // inputs snapshots
+    std::atomic<uint64_t> replaced{0};    // published over one the render thread never took
+};
+
+// The middle of the three pipeline stages: ingest fills the session stores, this thread
+// turns them into what the windows show (plot windows, derived metrics, reference laps),
+// and the render thread draws the newest snapshot. Each stage runs at its own pace, so a
+// slow frame or a dragged window (which blocks the render loop on some platforms) no
+// longer holds up reference tracking, and analysis time is off the frame.
+class TelemetryAnalysis {
+public:
+    TelemetryAnalysis() = default;
+    ~TelemetryAnalysis();
+
+    TelemetryAnalysis(const TelemetryAnalysis&) = delete;
+    TelemetryAnalysis& operator=(const TelemetryAnalysis&) = delete;
+
+    void start(const AnalysisConfig& config);
+    // Joins the thread, then saves every tracked session's reference lap
+    void stop();
+
+    // Render thread: the session and car (-1 = player) the inputs snapshots follow. Returns
+    // the id snapshots carry once they do; until then the newest one is for the old pick.
+    uint64_t select(std::shared_ptr<LiveSession> session, int focusCar);
+    // Render thread only: newest inputs snapshot, valid until the next call
+    const InputsSnapshot* latestInputs() { return inputs_.latest(); }
+    // Render thread: replaces `map` if a newer one was built since `version`; otherwise one
+    // atomic load. The map is for the picked session's track at the time it was built.
+    bool takeTrackMap(std::shared_ptr<const TrackMap>& map, uint64_t& version);
+
+    const AnalysisConfig& config() const { return config_; }
+    const AnalysisStats& stats() const { return stats_; }
+
+private:
+    static constexpr size_t kMaxSamples = InputsSnapshot::kMaxSamples;
+
+    void run();
+    void takeSelection();
+    void updateInputs();
+    void clearInputs();
+    void rebuildExtremes();
+    void applyRewinds(size_t inputIndex);
+    void publishInputs();
+    void updateTrackMap();
+    void updateReferenceLaps();
+    void saveReferenceLap(LiveSession& session);
+
+    AnalysisConfig config_;
+    AnalysisStats stats_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    // Pick handed over by select()
+    std::mutex selectMutex_;
+    std::shared_ptr<LiveSession> requestedSession_;
+    int requestedCar_ = -1;
+    std::atomic<uint64_t> requested_{0};
+
+    // Analysis thread only from here on
+    uint64_t selection_ = 0;
+    std::shared_ptr<LiveSession> session_;
+    int focusCar_ = -1;
+    bool inputsChanged_ = false;
+
+    // Plot windows, appended incrementally from the focused car's ring
+    size_t inputCursor_ = 0;
+    size_t rewindCursor_ = 0;
+    std::vector<LiveRewind> pendingRewinds_;   // flashbacks not yet reached by inputCursor_
+    PlotWindow<double> throttle_{kMaxSamples};
+    PlotWindow<double> brake_{kMaxSamples};
+    PlotWindow<double> steer_{kMaxSamples};
+    PlotWindow<double> time_{kMaxSamples};
+    PlotWindow<int> drs_{kMaxSamples};
+    PlotWindow<int> gear_{kMaxSamples};
+    WindowExtreme<double, std::greater<double>> throttleMax_{kMaxSamples};
+    WindowExtreme<double, std::greater<double>> brakeMax_{kMaxSamples};
+    WindowExtreme<double, std::greater<double>> steerMax_{kMaxSamples};
+    WindowExtreme<double, std::less<double>> steerMin_{kMaxSamples};
+
+    SnapshotBuffer<InputsSnapshot> inputs_;
+    uint64_t sequence_ = 0;
+
+    // Mini map: rebuilt when the picked session's track changes, looked for once per track
+    int mapTrackId_ = -1;
+    std::mutex trackMapMutex_;
+    std::shared_ptr<const TrackMap> trackMap_;
+    std::atomic<uint64_t> trackMapVersion_{0};
+
+    // --reference-lap: sessions being recorded; the list is fetched again only when the
+    // registry changed
+    std::vector<std::shared_ptr<LiveSession>> referenceSessions_;
+    uint64_t referenceGeneration_ = ~0ull;
+    std::vector<int> savedTracks_;   // tracks whose reference lap was saved this run
+};
+
+extern TelemetryAnalysis g_analysis;
@@ -0,0 +1,89 @@
+#include "TieredHistory.hpp"
+
+constexpr uint64_t TieredHistory::kPeriodMs[NUM_HISTORY_TIERS];
+
+TieredHistory::TieredHistory(const LiveHistoryConfig& config) {
+    configure(config);
+}
+
+size_t TieredHistory::capacity(const LiveHistoryConfig& config, HistoryTier t) {
+    const double seconds[NUM_HISTORY_TIERS] = {config.tier10HzSeconds, config.tier1HzSeconds};
+    size_t buckets = static_cast<size_t>(seconds[t] * 1000.0 / kPeriodMs[t]);
+    return buckets ? buckets : 1;
+}
+
+void TieredHistory::configure(const LiveHistoryConfig& config) {
+    for (size_t t = 0; t < NUM_HISTORY_TIERS; ++t) {
+        tiers_[t].reset(capacity(config, static_cast<HistoryTier>(t)));
+        acc_[t] = Accumulator{};
+    }
+}
+
+void TieredHistory::attach(const LiveHistoryConfig& config, BucketSlot* const storage[NUM_HISTORY_TIERS]) {
+    for (size_t t = 0; t < NUM_HISTORY_TIERS; ++t) {
+        tiers_[t].attach(storage[t], capacity(config, static_cast<HistoryTier>(t)));
+        acc_[t] = Accumulator{};
+    }
+}
+
+void TieredHistory::push(const LiveInputSample& sample) {
+    const float values[kChannels] = {
+        sample.throttle, sample.brake, sample.steer,
+        static_cast<float>(sample.speed), static_cast<float>(sample.engineRPM)
+    };
+
+    for (size_t t = 0; t < NUM_HISTORY_TIERS; ++t) {
+        Accumulator& acc = acc_[t];
+        uint64_t bucket = sample.timestampMs / kPeriodMs[t];
+
+        if (acc.open && bucket != acc.bucket) {
+            close(static_cast<HistoryTier>(t));
+        }
+        if (!acc.open) {
+            acc.open = true;
+            acc.bucket = bucket;
+            acc.samples = 0;
+            for (size_t c = 0; c < kChannels; ++c) {
+                acc.min[c] = values[c];
+                acc.max[c] = values[c];
+                acc.sum[c] = 0.0;
+            }
+        }
+
+        acc.samples++;
+        for (size_t c = 0; c < kChannels; ++c) {
+            if (values[c] < acc.min[c]) acc.min[c] = values[c];
+            if (values[c] > acc.max[c]) acc.max[c] = values[c];
+            acc.sum[c] += values[c];
+        }
+    }
+}
+
+void TieredHistory::close(HistoryTier t) {
+    Accumulator& acc = acc_[t];
+    SeriesStats stats[kChannels];
+    for (size_t c = 0; c < kChannels; ++c) {
+        stats[c] = {acc.min[c], acc.max[c], static_cast<float>(acc.sum[c] / acc.samples)};
+    }
+
+    LiveInputBucket out;
+    out.startMs = acc.bucket * kPeriodMs[t];
+    out.samples = acc.samples;
+    out.throttle = stats[0];
+    out.brake = stats[1];
+    out.steer = stats[2];
+    out.speed = stats[3];
+    out.engineRPM = stats[4];
+    tiers_[t].push(out);
+
+    acc.open = false;
+}
+
+void TieredHistory::rewind(uint64_t toMs) {
+    for (size_t t = 0; t < NUM_HISTORY_TIERS; ++t) {
+        Accumulator& acc = acc_[t];
+        if (acc.open && (acc.bucket + 1) * kPeriodMs[t] > toMs) {
+            acc.open = false;
+        }
+    }
+}
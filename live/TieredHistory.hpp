@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "LiveTelemetry.hpp"
+
+// Folds full-rate input samples into fixed-period min/max/mean buckets, one ring per
+// HistoryTier. A bucket is published when the first sample of the next one arrives, or
+// when session time jumps backwards (flashback / restart). Single writer.
+class TieredHistory {
+public:
+    using BucketSlot = RingBuffer<LiveInputBucket>::Slot;
+
+    TieredHistory() = default;   // unsized until configure() / attach()
+    explicit TieredHistory(const LiveHistoryConfig& config);
+
+    // Both only while nothing is pushing / reading. attach() places tier t in
+    // storage[t], which must hold capacity(config, t) slots.
+    void configure(const LiveHistoryConfig& config);
+    void attach(const LiveHistoryConfig& config, BucketSlot* const storage[NUM_HISTORY_TIERS]);
+
+    void push(const LiveInputSample& sample);
+
+    // Flashback to session time toMs: open buckets reaching past it are dropped, not
+    // published, so no bucket mixes the old and the replayed timeline
+    void rewind(uint64_t toMs);
+
+    static size_t capacity(const LiveHistoryConfig& config, HistoryTier t);
+
+    const RingBuffer<LiveInputBucket>& tier(HistoryTier t) const { return tiers_[t]; }
+    static uint64_t periodMs(HistoryTier t) { return kPeriodMs[t]; }
+
+private:
+    static constexpr size_t kChannels = 5;   // throttle, brake, steer, speed, engineRPM
+    static constexpr uint64_t kPeriodMs[NUM_HISTORY_TIERS] = {100, 1000};
+
+    struct Accumulator {
+        bool open = false;
+        uint64_t bucket = 0;      // timestampMs / period
+        uint32_t samples = 0;
+        float min[kChannels];
+        float max[kChannels];
+        double sum[kChannels];
+    };
+
+    void close(HistoryTier t);
+
+    RingBuffer<LiveInputBucket> tiers_[NUM_HISTORY_TIERS];
+    Accumulator acc_[NUM_HISTORY_TIERS];
+};
@@ -1,5 +1,9 @@
 #include "Visualizer.hpp"
-#include "LiveTelemetry.hpp"
+#include "udpListener.hpp"
+#include "asyncLogWriter.hpp"
+#include "latencyHistogram.hpp"
+#include "sequenceTracker.hpp"
+#include "allocationCounter.hpp"
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
@@ -7,32 +11,23 @@
 #include <implot.h>
 #include <iostream>
 #include <cmath>
+#include <cstdio>
 #include <string>
+#include <algorithm>
+#include <ctime>
 
 Visualizer::Visualizer(int windowWidth, int windowHeight)
     : m_windowWidth(windowWidth), m_windowHeight(windowHeight), m_window(nullptr) {
-    m_throttleHistory.reserve(MAX_HISTORY);
-    m_brakeHistory.reserve(MAX_HISTORY);
-    m_steerHistory.reserve(MAX_HISTORY);
-    m_timeHistory.reserve(MAX_HISTORY);
+    // Everything the frame loop appends to is sized here, so a steady frame never allocates
+    m_markerY.fill(1.15);
+    updateSessionLabel();
+    resetHistoryData();
 }
 
 Visualizer::~Visualizer() {
     shutdown();
 }
 
-std::vector<Vec3> loadReferenceLap(int trackId) {
-    if (trackId < 0) {
-        return {};
-    }
-    ReferenceTracker tracker;
-    if (tracker.loadReferenceLap(trackId)) {
-        return tracker.getLapPositions();
-    } else {
-        return {};
-    }
-}
-
 bool Visualizer::init() {
     // Initialize GLFW
     if (!glfwInit()) {
@@ -72,13 +67,7 @@ bool Visualizer::init() {
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
 
-    // Load reference lap
-    std::vector<Vec3> loaded_reference = loadReferenceLap(g_staticInfo.track_id);
-    if (loaded_reference.size() > 0) {
-        have_loaded_reference = true;
-        referenceLap_ = loaded_reference;
-        std::cout << "Loaded reference lap for track " << g_staticInfo.track_id << "\n";
-    }
+    // The mini map's reference lap is loaded by the analysis thread once a session reports its track
     return true;
 }
 
@@ -95,71 +84,249 @@ void Visualizer::shutdown() {
     }
 }
 
-void Visualizer::updatePlotData() {
-    LiveInputSample samples[512];
-    size_t count = LiveTelemetry::copyHistory(samples, 512);
-
-    m_throttleHistory.clear();
-    m_brakeHistory.clear();
-    m_steerHistory.clear();
-    m_timeHistory.clear();
-    m_clutchHistory.clear();
-    m_drsHistory.clear();
-    m_gearHistory.clear();
-
-    for (size_t i = 0; i < count; i++) {
-        m_throttleHistory.push_back(samples[i].throttle);
-        m_brakeHistory.push_back(samples[i].brake);
-        m_steerHistory.push_back(samples[i].steer);
-        m_clutchHistory.push_back(static_cast<int>(samples[i].clutch));
-        m_drsHistory.push_back(static_cast<int>(samples[i].drs));
-        m_gearHistory.push_back(static_cast<int>(samples[i].gear));
-        m_timeHistory.push_back(samples[i].timestampMs / 1000.0);  // Convert ms to seconds
+// Picks up sessions that started or were evicted since the last frame
+void Visualizer::refreshSession() {
+    uint64_t generation = g_sessions.generation();
+    if (generation == m_sessionGeneration) return;
+    m_sessionGeneration = generation;
+
+    if (m_followNewest) {
+        std::shared_ptr<LiveSession> newest = g_sessions.newest();
+        if (newest && newest != m_session) selectSession(newest);
+    } else if (m_session && !g_sessions.find(m_session->key())) {
+        // The picked session went idle and was evicted: keep showing what it had
+        std::cout << "Session " << describeSession(m_session->key()) << " is no longer live\n";
     }
 }
 
-void Visualizer::drawMiniMap() {
-    if (!have_loaded_reference){
-        std::vector<Vec3> loaded_reference = loadReferenceLap(g_staticInfo.track_id);
-        if (loaded_reference.size() > 0) {
-            have_loaded_reference = true;
-            referenceLap_ = loaded_reference;
-            std::cout << "Loaded reference lap for track " << g_staticInfo.track_id << "\n";
-        } else {
-            return;
+// Every window starts over from the new session's stores
+void Visualizer::selectSession(std::shared_ptr<LiveSession> session) {
+    m_session = std::move(session);
+    m_focusCar = -1;
+    selectInputs();
+    resetHistoryData();
+    updateSessionLabel();
+}
+
+void Visualizer::updateSessionLabel() {
+    m_sessionLabel = m_session ? describeSession(m_session->key()) : "Waiting for a session";
+    if (m_followNewest) m_sessionLabel = "Newest: " + m_sessionLabel;
+}
+
+void Visualizer::drawSessionPicker() {
+    if (ImGui::BeginCombo("Session", m_sessionLabel.c_str())) {
+        // Listed only while the picker is open
+        std::vector<std::shared_ptr<LiveSession>> sessions = g_sessions.sessions();
+        if (ImGui::Selectable("Follow newest", m_followNewest)) {
+            m_followNewest = true;
+            m_sessionGeneration = ~0ull;   // re-select on the next frame
+            updateSessionLabel();
         }
+        for (const std::shared_ptr<LiveSession>& session : sessions) {
+            std::string label = describeSession(session->key());
+            if (session->info.track_id >= 0) label += "  track " + std::to_string(session->info.track_id);
+            label += "  (" + std::to_string(session->packets.load(std::memory_order_relaxed)) + " packets)";
+            if (ImGui::Selectable(label.c_str(), !m_followNewest && session == m_session)) {
+                m_followNewest = false;
+                if (session != m_session) selectSession(session);
+                updateSessionLabel();
+            }
+        }
+        ImGui::EndCombo();
     }
+}
 
-    ImGui::Begin("Mini Map");
+// The analysis thread starts over on the new session / car; until its first snapshot for
+// them arrives, the plots show nothing rather than the previous pick
+void Visualizer::selectInputs() {
+    m_selection = g_analysis.select(m_session, m_focusCar);
+    m_inputs = nullptr;
+}
+
+void Visualizer::takeInputs() {
+    const InputsSnapshot* inputs = g_analysis.latestInputs();
+    m_inputs = (inputs && inputs->selection == m_selection) ? inputs : nullptr;
+}
+
+void Visualizer::resetHistoryData() {
+    size_t capacity = m_session ? m_session->player.bucketCapacity(static_cast<HistoryTier>(m_historyTier)) : 0;
+    m_bucketCursor = 0;
+    m_bucketTime.reset(capacity);
+    m_bucketThrottle.reset(capacity);
+    m_bucketBrake.reset(capacity);
+    m_bucketSpeedMin.reset(capacity);
+    m_bucketSpeedMax.reset(capacity);
+    m_bucketSpeedMean.reset(capacity);
+    m_historyInputsLod.clear();
+    m_historySpeedLod.clear();
+}
+
+void Visualizer::updateHistoryData() {
+    if (!m_session) return;
+
+    LiveInputBucket buckets[256];
+    for (;;) {
+        bool overrun = false;
+        size_t count = m_session->player.readBucketsSince(static_cast<HistoryTier>(m_historyTier),
+                                                          m_bucketCursor, buckets, 256, &overrun);
+        if (overrun) {
+            m_bucketTime.clear();
+            m_bucketThrottle.clear();
+            m_bucketBrake.clear();
+            m_bucketSpeedMin.clear();
+            m_bucketSpeedMax.clear();
+            m_bucketSpeedMean.clear();
+        }
+        if (count == 0) break;
+
+        for (size_t i = 0; i < count; i++) {
+            // After a flashback buckets start over from an earlier time: drop the rewound ones
+            double start = buckets[i].startMs / 1000.0;
+            size_t keep = m_bucketTime.size();
+            while (keep > 0 && m_bucketTime[keep - 1] >= start) keep--;
+            if (keep < m_bucketTime.size()) {
+                m_bucketTime.truncate(keep);
+                m_bucketThrottle.truncate(keep);
+                m_bucketBrake.truncate(keep);
+                m_bucketSpeedMin.truncate(keep);
+                m_bucketSpeedMax.truncate(keep);
+                m_bucketSpeedMean.truncate(keep);
+            }
+
+            m_bucketTime.push(start);
+            m_bucketThrottle.push(buckets[i].throttle.mean);
+            m_bucketBrake.push(buckets[i].brake.mean);
+            m_bucketSpeedMin.push(buckets[i].speed.min);
+            m_bucketSpeedMax.push(buckets[i].speed.max);
+            m_bucketSpeedMean.push(buckets[i].speed.mean);
+        }
+    }
+}
+
+void Visualizer::drawHistoryWindow() {
+    ImGui::Begin("Session History");
 
-    static std::vector<float> xs, zs; // top-down XZ view
-    xs.resize(referenceLap_.size());
-    zs.resize(referenceLap_.size());
+    const char* tiers[NUM_HISTORY_TIERS] = {"10 Hz (100 ms buckets)", "1 Hz (1 s buckets)"};
+    if (ImGui::Combo("Resolution", &m_historyTier, tiers, NUM_HISTORY_TIERS)) {
+        resetHistoryData();
+    }
+    updateHistoryData();
 
-    float minX = referenceLap_[0].x, maxX = referenceLap_[0].x;
-    float minZ = referenceLap_[0].z, maxZ = referenceLap_[0].z;
+    if (m_bucketTime.empty()) {
+        ImGui::Text("Waiting for the first bucket...");
+        ImGui::End();
+        return;
+    }
 
-    for (size_t i = 0; i < referenceLap_.size(); ++i) {
-        xs[i] = referenceLap_[i].x;
-        zs[i] = referenceLap_[i].z;
+    // Pan / zoom with the mouse, double-click to fit the whole history. Each plot draws its
+    // level-of-detail reduction for the current view, not every bucket.
+    int numBuckets = (int)m_bucketTime.size();
+    int drawnPoints = 0;
+    if (ImPlot::BeginPlot("Inputs (bucket mean)", ImVec2(-1, 200))) {
+        ImPlot::SetupAxes("Session time (s)", "Value", ImPlotAxisFlags_None, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxisLimits(ImAxis_X1, m_bucketTime[0], m_bucketTime.back(), ImGuiCond_Once);
+        ImPlotRect view = ImPlot::GetPlotLimits();
+        const double* inputs[2] = {m_bucketThrottle.data(), m_bucketBrake.data()};
+        m_historyInputsLod.update(m_bucketTime.data(), inputs, m_bucketTime.size(), view.X.Min, view.X.Max,
+                                  (int)ImPlot::GetPlotSize().x);
+        ImPlot::PlotLine("Throttle", m_historyInputsLod.lineX(0), m_historyInputsLod.lineY(0),
+                         m_historyInputsLod.lineSize(0));
+        ImPlot::PlotLine("Brake", m_historyInputsLod.lineX(1), m_historyInputsLod.lineY(1),
+                         m_historyInputsLod.lineSize(1));
+        drawnPoints += m_historyInputsLod.lineSize(0) + m_historyInputsLod.lineSize(1);
+        ImPlot::EndPlot();
+    }
 
-        if (xs[i] < minX) minX = xs[i];
-        if (xs[i] > maxX) maxX = xs[i];
-        if (zs[i] < minZ) minZ = zs[i];
-        if (zs[i] > maxZ) maxZ = zs[i];
+    if (ImPlot::BeginPlot("Speed (min / max / mean)", ImVec2(-1, 200))) {
+        ImPlot::SetupAxes("Session time (s)", "km/h", ImPlotAxisFlags_None, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxisLimits(ImAxis_X1, m_bucketTime[0], m_bucketTime.back(), ImGuiCond_Once);
+        ImPlotRect view = ImPlot::GetPlotLimits();
+        const double* speed[3] = {m_bucketSpeedMin.data(), m_bucketSpeedMax.data(), m_bucketSpeedMean.data()};
+        m_historySpeedLod.update(m_bucketTime.data(), speed, m_bucketTime.size(), view.X.Min, view.X.Max,
+                                 (int)ImPlot::GetPlotSize().x);
+        // Band: lowest min to highest max in each column
+        ImPlot::SetNextFillStyle(IMPLOT_AUTO_COL, 0.25f);
+        ImPlot::PlotShaded("Speed range", m_historySpeedLod.bandX(), m_historySpeedLod.bandMin(0),
+                           m_historySpeedLod.bandMax(1), m_historySpeedLod.bandSize());
+        ImPlot::PlotLine("Speed", m_historySpeedLod.lineX(2), m_historySpeedLod.lineY(2),
+                         m_historySpeedLod.lineSize(2));
+        drawnPoints += m_historySpeedLod.bandSize() + m_historySpeedLod.lineSize(2);
+        ImPlot::EndPlot();
+    }
+
+    ImGui::Text("Buckets: %d / %zu, %d points drawn", numBuckets, m_bucketTime.capacity(), drawnPoints);
+
+    ImGui::End();
+}
+
+void Visualizer::drawFieldWindow() {
+    if (!m_session || !m_session->field.read(m_field)) {
+        return;
+    }
+
+    ImGui::Begin("Field");
+
+    // Running order from the lap data arrays
+    size_t order[kMaxCars];
+    size_t numCars = 0;
+    for (size_t i = 0; i < kMaxCars; ++i) {
+        if (m_field.carPosition[i] > 0) order[numCars++] = i;
+    }
+    std::sort(order, order + numCars, [this](size_t a, size_t b) {
+        return m_field.carPosition[a] < m_field.carPosition[b];
+    });
+
+    if (ImGui::BeginTable("FieldTable", 7, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+        ImGui::TableSetupColumn("Pos");
+        ImGui::TableSetupColumn("Car");
+        ImGui::TableSetupColumn("Lap");
+        ImGui::TableSetupColumn("Gap ahead (s)");
+        ImGui::TableSetupColumn("Speed");
+        ImGui::TableSetupColumn("Tyre age");
+        ImGui::TableSetupColumn("Pit");
+        ImGui::TableHeadersRow();
+
+        for (size_t k = 0; k < numCars; ++k) {
+            size_t i = order[k];
+            ImGui::TableNextRow();
+            if (i == m_field.playerCarIndex) {
+                ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, ImGui::GetColorU32(ImVec4(0.2f, 0.4f, 0.8f, 0.35f)));
+            }
+            ImGui::TableNextColumn(); ImGui::Text("%d", m_field.carPosition[i]);
+            ImGui::TableNextColumn(); ImGui::Text("%zu", i);
+            ImGui::TableNextColumn(); ImGui::Text("%d", m_field.currentLapNum[i]);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", m_field.deltaToCarInFrontMs[i] / 1000.0);
+            ImGui::TableNextColumn(); ImGui::Text("%d km/h", m_field.speed[i]);
+            ImGui::TableNextColumn(); ImGui::Text("%d laps", m_field.tyresAgeLaps[i]);
+            ImGui::TableNextColumn(); ImGui::Text("%s", m_field.pitStatus[i] == 1 ? "pitting" :
+                                                        m_field.pitStatus[i] == 2 ? "in pit" : "");
+        }
+        ImGui::EndTable();
     }
 
-    // Add 5% buffer around edges
-    float xBuffer = (maxX - minX) * 0.05f;
-    float zBuffer = (maxZ - minZ) * 0.05f;
+    ImGui::Text("Frame %u, %llu frames published", m_field.frameIdentifier,
+                (unsigned long long)m_session->field.framesPublished());
+
+    ImGui::End();
+}
+
+void Visualizer::drawMiniMap() {
+    if (!m_session) return;
+    // Loaded, bounded and decimated off this thread once per track: a frame only draws the
+    // cached polyline and moves the car marker
+    g_analysis.takeTrackMap(m_trackMap, m_trackMapVersion);
+    if (!m_trackMap || m_trackMap->trackId != m_session->info.track_id) return;
+    const TrackMap& map = *m_trackMap;
+
+    ImGui::Begin("Mini Map");
 
     if (ImPlot::BeginPlot("Track", ImVec2(300, 300),
                           ImPlotFlags_NoLegend | ImPlotFlags_NoMouseText |
                           ImPlotFlags_NoBoxSelect)) {
 
-        // Set axes limits with buffer
-        ImPlot::SetupAxisLimits(ImAxis_X1, minX - xBuffer, maxX + xBuffer);
-        ImPlot::SetupAxisLimits(ImAxis_Y1, minZ - zBuffer, maxZ + zBuffer);
+        // Axis limits include a 5% margin
+        ImPlot::SetupAxisLimits(ImAxis_X1, map.minX, map.maxX);
+        ImPlot::SetupAxisLimits(ImAxis_Y1, map.minZ, map.maxZ);
 
         // Remove tick labels/decorations
         ImPlot::SetupAxis(ImAxis_X1, nullptr, ImPlotAxisFlags_NoTickLabels | ImPlotAxisFlags_NoDecorations);
@@ -167,12 +334,12 @@ void Visualizer::drawMiniMap() {
 
         // Plot thick line
         ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, 8.0f); // much thicker
-        ImPlot::PlotLine("Reference Lap", xs.data(), zs.data(), (int)xs.size());
+        ImPlot::PlotLine("Reference Lap", map.xs.data(), map.zs.data(), (int)map.xs.size());
         ImPlot::PopStyleVar();
 
 
         LivePositionSample latest_position;
-        LiveTelemetry::peekLatestPosition(latest_position);
+        m_session->player.peekLatestPosition(latest_position);
         float carX = latest_position.worldX;
         float carZ = latest_position.worldZ;
         ImPlot::PlotScatter("Car Position", &carX, &carZ, 1);
@@ -189,22 +356,35 @@ void Visualizer::drawUI() {
     ImGui::SetNextWindowSize(ImVec2(m_windowWidth, m_windowHeight), ImGuiCond_FirstUseEver);
     ImGui::Begin("Driver Inputs");
 
+    // Several rigs can send to this host; every window shows the one picked here
+    drawSessionPicker();
+
+    // Any car's history is kept, so the plots can follow someone other than the player
+    static std::string carLabels[kMaxCars + 1];
+    static const char* carItems[kMaxCars + 1];
+    if (!carItems[0]) {
+        carLabels[0] = "Player";
+        for (size_t car = 0; car < kMaxCars; ++car) carLabels[car + 1] = "Car " + std::to_string(car);
+        for (size_t i = 0; i <= kMaxCars; ++i) carItems[i] = carLabels[i].c_str();
+    }
+    int focusItem = m_focusCar + 1;
+    if (ImGui::Combo("Car", &focusItem, carItems, static_cast<int>(kMaxCars + 1))) {
+        m_focusCar = focusItem - 1;
+        selectInputs();
+    }
+
     if (ImPlot::BeginPlot("Throttle / Brake / Steer", ImVec2(-1, 400))) {
         // Setup axes with time X axis and auto-fit Y
         ImPlot::SetupAxes("Time (s)", "Value", ImPlotAxisFlags_None, ImPlotAxisFlags_AutoFit);
         ImPlot::SetupLegend(ImPlotLocation_North, ImPlotLegendFlags_Outside);
 
-        if (!m_timeHistory.empty()) {
-            int numSamples = (int)m_timeHistory.size();
+        if (m_inputs && m_inputs->count > 0) {
+            int numSamples = (int)m_inputs->count;
 
-            // Compute seconds-ago X values so newest point is 0 and older points are negative
-            std::vector<double> xvals(numSamples);
-            double tEnd = m_timeHistory.back();
-            for (int i = 0; i < numSamples; ++i) {
-                xvals[i] = m_timeHistory[i] - tEnd; // negative or zero
-            }
+            // Seconds-ago X values: newest point is 0 and older points are negative
+            const double* xvals = m_inputs->secondsAgo.data();
 
-            double xmin = xvals.front(); // oldest (most negative)
+            double xmin = xvals[0]; // oldest (most negative)
             double xmax = 0.0; // newest
             // Must set axis limits before plotting
             ImPlot::SetupAxisLimits(ImAxis_X1, xmin, xmax, ImGuiCond_Always);
@@ -212,27 +392,12 @@ void Visualizer::drawUI() {
             ImPlot::SetupAxisLimits(ImAxis_Y1, -1.2, 1.3, ImGuiCond_Always);
 
             // Plot using seconds-ago X values
-            ImPlot::PlotLine("Throttle", xvals.data(), m_throttleHistory.data(), numSamples);
-            ImPlot::PlotLine("Brake", xvals.data(), m_brakeHistory.data(), numSamples);
-            ImPlot::PlotLine("Steer", xvals.data(), m_steerHistory.data(), numSamples);
-
-            // Build marker lists for gear-change events (detect when gear differs from previous sample)
-            std::vector<double> gearUpX, gearUpY;
-            std::vector<double> gearDownX, gearDownY;
-            for (int i = 1; i < numSamples; ++i) {
-                int prev = m_gearHistory[i-1];
-                int cur = m_gearHistory[i];
-                if (cur != prev) {
-                    double x = xvals[i];
-                    if (cur > prev) {
-                        gearUpX.push_back(x);
-                        gearUpY.push_back(1.15);
-                    } else {
-                        gearDownX.push_back(x);
-                        gearDownY.push_back(1.15);
-                    }
-                }
-            }
+            ImPlot::PlotLine("Throttle", xvals, m_inputs->throttle.data(), numSamples);
+            ImPlot::PlotLine("Brake", xvals, m_inputs->brake.data(), numSamples);
+            ImPlot::PlotLine("Steer", xvals, m_inputs->steer.data(), numSamples);
+
+            // Gear-change markers (where gear differs from the previous sample)
+            int gearUps = (int)m_inputs->gearUps, gearDowns = (int)m_inputs->gearDowns;
 
             // Draw DRS as shaded horizontal bands spanning contiguous DRS-on ranges
             ImVec2 plotPos = ImPlot::GetPlotPos();
@@ -252,18 +417,10 @@ void Visualizer::drawUI() {
             ImDrawList* plotDL = ImPlot::GetPlotDrawList();
             const float bandTop = yToPixel(1.05);
             const float bandBottom = yToPixel(0.85);
-            // Scan for contiguous DRS-on ranges
-            int idx = 0;
-            while (idx < numSamples) {
-                // find start
-                while (idx < numSamples && m_drsHistory[idx] == 0) ++idx;
-                if (idx >= numSamples) break;
-                int start = idx;
-                while (idx < numSamples && m_drsHistory[idx] != 0) ++idx;
-                int end = idx - 1;
-
-                double xStart = xvals[start];
-                double xEnd = xvals[end];
+            // Contiguous DRS-on ranges
+            for (size_t span = 0; span < m_inputs->drsSpans; ++span) {
+                double xStart = m_inputs->drsStartX[span];
+                double xEnd = m_inputs->drsEndX[span];
                 float px0 = xToPixel(xStart);
                 float px1 = xToPixel(xEnd);
                 // Clamp within plot region
@@ -278,15 +435,15 @@ void Visualizer::drawUI() {
                 plotDL->AddRect(ImVec2(px0, bandTop), ImVec2(px1, bandBottom), borderCol, 0.0f, 0, 1.0f);
             }
 
-            if (!gearUpX.empty()) {
+            if (gearUps > 0) {
                 ImVec4 upCol = ImVec4(0.0f, 1.0f, 0.0f, 1.0f);
                 ImPlot::SetNextMarkerStyle(ImPlotMarker_Square, 7, upCol);
-                ImPlot::PlotScatter("Upshift", gearUpX.data(), gearUpY.data(), (int)gearUpX.size());
+                ImPlot::PlotScatter("Upshift", m_inputs->gearUpX.data(), m_markerY.data(), gearUps);
             }
-            if (!gearDownX.empty()) {
+            if (gearDowns > 0) {
                 ImVec4 downCol = ImVec4(1.0f, 0.0f, 0.0f, 1.0f);
                 ImPlot::SetNextMarkerStyle(ImPlotMarker_Square, 7, downCol);
-                ImPlot::PlotScatter("Downshift", gearDownX.data(), gearDownY.data(), (int)gearDownX.size());
+                ImPlot::PlotScatter("Downshift", m_inputs->gearDownX.data(), m_markerY.data(), gearDowns);
             }
         }
 
@@ -298,12 +455,13 @@ void Visualizer::drawUI() {
     ImGui::Separator();
     ImGui::Text("Live Values:");
     
-    if (!m_throttleHistory.empty()) {
-        ImGui::Text("Throttle: %.2f%%", m_throttleHistory.back() * 100.0f);
+    if (m_inputs && m_inputs->count > 0) {
+        size_t newest = m_inputs->count - 1;
+        ImGui::Text("Throttle: %.2f%%", m_inputs->throttle[newest] * 100.0f);
         ImGui::SameLine(200);
-        ImGui::Text("Brake: %.2f%%", m_brakeHistory.back() * 100.0f);
+        ImGui::Text("Brake: %.2f%%", m_inputs->brake[newest] * 100.0f);
         ImGui::SameLine(400);
-        ImGui::Text("Steer: %.2f", m_steerHistory.back());
+        ImGui::Text("Steer: %.2f", m_inputs->steer[newest]);
     } else {
         ImGui::Text("Waiting for telemetry data...");
     }
@@ -311,19 +469,29 @@ void Visualizer::drawUI() {
     // Car Inputs live window - show latest full telemetry sample (peekLatest)
     {
         LiveInputSample latest;
-        if (LiveTelemetry::peekLatest(latest)) {
+        bool haveLatest = false;
+        if (!m_session) {
+            // nothing received yet
+        } else if (m_focusCar < 0) {
+            haveLatest = m_session->player.peekLatest(latest);
+        } else {
+            LiveInputSample field[kMaxCars];
+            haveLatest = m_session->cars.peekLatest(carMask(static_cast<size_t>(m_focusCar)), field) != 0;
+            if (haveLatest) latest = field[m_focusCar];
+        }
+        if (haveLatest) {
             ImGui::Begin("Car Inputs");
             // Big speed + gear
             // Prepare gear label
-            std::string gearLabel;
-            if (latest.gear == -1) gearLabel = "R";
-            else if (latest.gear == 0) gearLabel = "N";
-            else gearLabel = std::to_string(static_cast<int>(latest.gear));
+            char gearLabel[8];
+            if (latest.gear == -1) std::snprintf(gearLabel, sizeof(gearLabel), "R");
+            else if (latest.gear == 0) std::snprintf(gearLabel, sizeof(gearLabel), "N");
+            else std::snprintf(gearLabel, sizeof(gearLabel), "%d", static_cast<int>(latest.gear));
 
             ImGui::PushFont(ImGui::GetFont());
             ImGui::Text("%u km/h", latest.speed);
             ImGui::SameLine(200);
-            ImGui::Text("Gear: %s", gearLabel.c_str());
+            ImGui::Text("Gear: %s", gearLabel);
             ImGui::PopFont();
 
             // RPM bar (colored, with redline)
@@ -411,27 +579,170 @@ void Visualizer::drawUI() {
         }
     }
 
-    ImGui::Text("Samples in buffer: %zu / %zu", m_throttleHistory.size(), MAX_HISTORY);
+    ImGui::Text("Samples in buffer: %zu / %zu", m_inputs ? m_inputs->count : 0, MAX_HISTORY);
 
     ImGui::End();
 
     // Stats window
     ImGui::Begin("Statistics");
 
-    if (!m_throttleHistory.empty()) {
-        double throttleMax = *std::max_element(m_throttleHistory.begin(), m_throttleHistory.end());
-        double brakeMax = *std::max_element(m_brakeHistory.begin(), m_brakeHistory.end());
-        double steerMax = *std::max_element(m_steerHistory.begin(), m_steerHistory.end());
-        double steerMin = *std::min_element(m_steerHistory.begin(), m_steerHistory.end());
+    if (m_inputs && m_inputs->count > 0) {
+        ImGui::Text("Throttle Max: %.2f%%", m_inputs->throttleMax * 100.0);
+        ImGui::Text("Brake Max: %.2f%%", m_inputs->brakeMax * 100.0);
+        ImGui::Text("Steer Range: [%.2f, %.2f]", m_inputs->steerMin, m_inputs->steerMax);
+    }
 
-        ImGui::Text("Throttle Max: %.2f%%", throttleMax * 100.0);
-        ImGui::Text("Brake Max: %.2f%%", brakeMax * 100.0);
-        ImGui::Text("Steer Range: [%.2f, %.2f]", steerMin, steerMax);
+    const UDPListenerStats& ingest = getUDPListenerStats();
+    ImGui::Separator();
+    ImGui::Text("Ingest: %llu packets / %llu syscalls (%.2f per syscall, max batch %llu), %llu rejected",
+                (unsigned long long)ingest.packets.load(std::memory_order_relaxed),
+                (unsigned long long)ingest.syscalls.load(std::memory_order_relaxed),
+                ingest.packetsPerSyscall(),
+                (unsigned long long)ingest.maxBatch.load(std::memory_order_relaxed),
+                (unsigned long long)ingest.rejected.load(std::memory_order_relaxed));
+    uint64_t listeners = ingest.listeners.load(std::memory_order_relaxed);
+    for (uint64_t i = 0; listeners > 1 && i < listeners; ++i) {
+        ImGui::Text("  listener %llu: %llu packets", (unsigned long long)i,
+                    (unsigned long long)ingest.perListener[i].load(std::memory_order_relaxed));
+    }
+    const AsyncLogStats& log = g_packetLog.stats();
+    ImGui::Text("Packet log: %llu written, %llu dropped, queue high water %llu, capture %.1f MB",
+                (unsigned long long)log.written.load(std::memory_order_relaxed),
+                (unsigned long long)log.dropped.load(std::memory_order_relaxed),
+                (unsigned long long)log.highWater.load(std::memory_order_relaxed),
+                log.captureBytes.load(std::memory_order_relaxed) / (1024.0 * 1024.0));
+    g_packetBus.stats(m_busStats);
+    for (const BusSubscriberStats& sub : m_busStats) {
+        ImGui::Text("  %s (%s): %llu delivered, %llu dropped", sub.name.c_str(),
+                    sub.delivery == BusDelivery::Inline ? "inline" : "worker",
+                    (unsigned long long)sub.delivered,
+                    (unsigned long long)sub.dropped);
+    }
+    const SessionRegistryStats& registry = g_sessions.stats();
+    ImGui::Text("Sessions: %llu live, %llu created, %llu evicted",
+                (unsigned long long)registry.active.load(std::memory_order_relaxed),
+                (unsigned long long)registry.created.load(std::memory_order_relaxed),
+                (unsigned long long)registry.evicted.load(std::memory_order_relaxed));
+    if (m_session) {
+        const FrameAssemblerStats& frames = m_session->frames.stats();
+        ImGui::Text("Frames: %llu complete, %llu partial (%llu evicted), %llu late packets",
+                    (unsigned long long)frames.complete.load(std::memory_order_relaxed),
+                    (unsigned long long)frames.partial.load(std::memory_order_relaxed),
+                    (unsigned long long)frames.evicted.load(std::memory_order_relaxed),
+                    (unsigned long long)frames.late.load(std::memory_order_relaxed));
+    }
+    const AnalysisStats& analysis = g_analysis.stats();
+    uint64_t ticks = analysis.ticks.load(std::memory_order_relaxed);
+    ImGui::Text("Render: %.0f fps. Analysis: %.0f Hz, %.1f%% busy, %llu late; %llu snapshots (%llu replaced unread)",
+                ImGui::GetIO().Framerate, g_analysis.config().rateHz,
+                ticks ? 100.0 * analysis.busyNs.load(std::memory_order_relaxed) * g_analysis.config().rateHz / (ticks * 1e9) : 0.0,
+                (unsigned long long)analysis.late.load(std::memory_order_relaxed),
+                (unsigned long long)analysis.published.load(std::memory_order_relaxed),
+                (unsigned long long)analysis.replaced.load(std::memory_order_relaxed));
+    if (m_inputs) {
+        ImGui::Text("Inputs snapshot age: %.1f ms", (monotonicNowNs() - m_inputs->builtNs) / 1e6);
+    }
+    ImGui::Checkbox("Latency overlay", &m_showLatency);
+    if (kCountingAllocations) {
+        ImGui::Text("Render thread heap allocations: %llu last frame, %llu frames allocated",
+                    (unsigned long long)m_frameAllocations, (unsigned long long)m_allocatingFrames);
+    }
+
+    const SequenceStats& seq = g_sequenceTracker.stats();
+    if (ImGui::CollapsingHeader("Packet sequence")) {
+        ImGui::Text("Sessions: %llu, flashbacks: %llu (last frame %u -> %u)",
+                    (unsigned long long)seq.sessions.load(std::memory_order_relaxed),
+                    (unsigned long long)seq.flashbacks.load(std::memory_order_relaxed),
+                    seq.lastFlashbackFrom.load(std::memory_order_relaxed),
+                    seq.lastFlashbackTo.load(std::memory_order_relaxed));
+        if (ImGui::BeginTable("sequence", 5, ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Packet");
+            ImGui::TableSetupColumn("Received");
+            ImGui::TableSetupColumn("Lost");
+            ImGui::TableSetupColumn("Duplicate");
+            ImGui::TableSetupColumn("Out of order");
+            ImGui::TableHeadersRow();
+            for (size_t id = 0; id < kNumPacketTypes; ++id) {
+                const SequenceTypeStats& type = seq.types[id];
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(packetTypeInfo(static_cast<uint8_t>(id))->name);
+                ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)type.received.load(std::memory_order_relaxed));
+                ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)type.gaps.load(std::memory_order_relaxed));
+                ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)type.duplicates.load(std::memory_order_relaxed));
+                ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)type.outOfOrder.load(std::memory_order_relaxed));
+            }
+            ImGui::EndTable();
+        }
     }
 
     drawMiniMap();
 
     ImGui::End();
+
+    drawHistoryWindow();
+    drawFieldWindow();
+    drawLatencyOverlay();
+}
+
+void Visualizer::drawLatencyOverlay() {
+    if (!m_showLatency) return;
+
+    // Small translucent panel pinned to the top-right corner
+    const ImGuiViewport* viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x - 10.0f, viewport->WorkPos.y + 10.0f),
+                            ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowBgAlpha(0.35f);
+    ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                             ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+                             ImGuiWindowFlags_NoNav;
+    if (!ImGui::Begin("Latency", nullptr, flags)) {
+        ImGui::End();
+        return;
+    }
+
+    const UDPListenerStats& ingest = getUDPListenerStats();
+    uint64_t packets = ingest.packets.load(std::memory_order_relaxed);
+    ImGui::Text("Latency from kernel receive (us), %.0f%% kernel stamped",
+                packets ? 100.0 * ingest.kernelStamped.load(std::memory_order_relaxed) / packets : 0.0);
+
+    if (ImGui::BeginTable("latency", 6, ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("Stage");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("p99.9");
+        ImGui::TableSetupColumn("max");
+        ImGui::TableSetupColumn("count");
+        ImGui::TableHeadersRow();
+        for (size_t stage = 0; stage < NUM_LATENCY_STAGES; ++stage) {
+            LatencyHistogram::Summary s = g_latency[stage].summary();
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(latencyStageName(static_cast<LatencyStage>(stage)));
+            ImGui::TableNextColumn(); ImGui::Text("%.1f", s.p50Ns / 1000.0);
+            ImGui::TableNextColumn(); ImGui::Text("%.1f", s.p99Ns / 1000.0);
+            ImGui::TableNextColumn(); ImGui::Text("%.1f", s.p999Ns / 1000.0);
+            ImGui::TableNextColumn(); ImGui::Text("%.1f", s.maxNs / 1000.0);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)s.count);
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::SmallButton("Export")) {
+        char name[64];
+        time_t t = std::time(nullptr);
+        std::strftime(name, sizeof(name), "latency_%Y%m%d_%H%M%S.hgrm", std::localtime(&t));
+        m_latencyExportStatus = writeLatencyReport(name) ? std::string("Wrote ") + name : "Export failed";
+    }
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Reset")) {
+        for (auto& histogram : g_latency) histogram.reset();
+        m_latencyExportStatus.clear();
+    }
+    if (!m_latencyExportStatus.empty()) {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(m_latencyExportStatus.c_str());
+    }
+
+    ImGui::End();
 }
 
 bool Visualizer::update() {
@@ -442,13 +753,18 @@ bool Visualizer::update() {
     }
 
     // Start frame
+    uint64_t allocations = threadAllocations();
+    m_frameAllocations = allocations - m_frameAllocationsStart;
+    if (m_frameAllocations > 0) m_allocatingFrames++;
+    m_frameAllocationsStart = allocations;
     glfwPollEvents();
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
 
-    // Update plot data from ring buffer
-    updatePlotData();
+    // Newest analysis snapshot for the selected session / car
+    refreshSession();
+    takeInputs();
 
     // Draw UI
     drawUI();
@@ -465,6 +781,16 @@ bool Visualizer::update() {
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
     glfwSwapBuffers(window);
-    
+
+    // Samples new in this frame's snapshot are on screen now
+    if (m_inputs && m_inputs->sequence != m_inputsSequence) {
+        m_inputsSequence = m_inputs->sequence;
+        uint64_t presentedNs = monotonicNowNs();
+        for (size_t i = 0; i < m_inputs->receivedCount; ++i) {
+            uint64_t receivedNs = m_inputs->receivedNs[i];
+            g_latency[LATENCY_RENDER].record(presentedNs > receivedNs ? presentedNs - receivedNs : 0);
+        }
+    }
+
     return true;
 }
@@ -1,7 +1,16 @@
 #pragma once
+#include <array>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
+#include <string>
+#include <memory>
 #include "ReferenceTracker.hpp"
+#include "PlotWindow.hpp"
+#include "PlotLod.hpp"
+#include "FieldState.hpp"
+#include "SessionRegistry.hpp"
+#include "TelemetryAnalysis.hpp"
 
 class Visualizer {
 public:
@@ -21,23 +30,67 @@ private:
     int m_windowWidth;
     int m_windowHeight;
     void* m_window;  // GLFWwindow*
-    bool have_loaded_reference = false;
-
-    // Plot history buffers
-    // Use double for all plot arrays so ImPlot can take xs and ys with the same type
-    std::vector<double> m_throttleHistory;
-    std::vector<double> m_brakeHistory;
-    std::vector<double> m_steerHistory;
-    std::vector<double> m_timeHistory;
-    std::vector<int> m_clutchHistory;
-    std::vector<int> m_drsHistory;
-    std::vector<int> m_gearHistory;
-    
-    std::vector<Vec3> referenceLap_;
-    
-    static constexpr size_t MAX_HISTORY = 512;
-
-    void updatePlotData();
+
+    static constexpr size_t MAX_HISTORY = InputsSnapshot::kMaxSamples;
+
+    // Session every window reads from. Held here, so it stays readable after the registry
+    // evicts it; follows the newest session unless one was picked.
+    std::shared_ptr<LiveSession> m_session;
+    bool m_followNewest = true;
+    uint64_t m_sessionGeneration = ~0ull;
+    std::string m_sessionLabel;   // picker preview, rebuilt only when the selection changes
+
+    // Car shown in Driver Inputs / Car Inputs: -1 = player (the session's player store),
+    // else a car index into the session's per-car history
+    int m_focusCar = -1;
+
+    // Driver Inputs plots and their derived metrics come ready-made from the analysis
+    // thread (g_analysis): the newest snapshot for m_selection, or null until there is one
+    uint64_t m_selection = 0;
+    const InputsSnapshot* m_inputs = nullptr;
+    uint64_t m_inputsSequence = 0;   // last snapshot drawn, to record its latency once
+    std::array<double, MAX_HISTORY> m_markerY;   // gear marker heights
+
+    // Session History window: one downsampled tier, appended incrementally
+    int m_historyTier = TIER_1HZ;
+    size_t m_bucketCursor = 0;
+    PlotWindow<double> m_bucketTime{0};
+    PlotWindow<double> m_bucketThrottle{0};
+    PlotWindow<double> m_bucketBrake{0};
+    PlotWindow<double> m_bucketSpeedMin{0};
+    PlotWindow<double> m_bucketSpeedMax{0};
+    PlotWindow<double> m_bucketSpeedMean{0};
+    // What the history plots draw: at most two points per pixel column of each plot's
+    // current view, cached per view (throttle / brake; speed min / max / mean)
+    PlotLod m_historyInputsLod{2};
+    PlotLod m_historySpeedLod{3};
+
+    FieldSnapshot m_field;   // latest whole-field frame, refreshed each UI frame
+    std::vector<BusSubscriberStats> m_busStats;   // refilled in place each frame
+
+    bool m_showLatency = true;
+    std::string m_latencyExportStatus;
+
+    // Mini map geometry, built by the analysis thread once per track
+    std::shared_ptr<const TrackMap> m_trackMap;
+    uint64_t m_trackMapVersion = 0;
+
+    // Debug builds: heap allocations made by the render thread in the last full frame
+    uint64_t m_frameAllocationsStart = 0;
+    uint64_t m_frameAllocations = 0;
+    uint64_t m_allocatingFrames = 0;
+
+    void refreshSession();
+    void selectSession(std::shared_ptr<LiveSession> session);
+    void drawSessionPicker();
+    void updateSessionLabel();
+    void selectInputs();
+    void takeInputs();
+    void resetHistoryData();
+    void updateHistoryData();
     void drawUI();
     void drawMiniMap();
+    void drawHistoryWindow();
+    void drawFieldWindow();
+    void drawLatencyOverlay();
 };
@@ -0,0 +1,196 @@
+#include "headless.hpp"
+#include "udpListener.hpp"
+#include "asyncLogWriter.hpp"
+#include "udpRelay.hpp"
+#include "SessionRegistry.hpp"
+#include "TelemetryAnalysis.hpp"
+#include "latencyHistogram.hpp"
+#include "sequenceTracker.hpp"
+#include "sessionReplay.hpp"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+static volatile std::sig_atomic_t g_stopRequested = 0;
+
+static void requestStop(int) {
+    g_stopRequested = 1;
+}
+
+// Everything the status line and stats file report, read once per period
+struct StatusSample {
+    double uptimeSeconds;
+    bool replay;
+    uint64_t packets;           // received, or published by the replay
+    uint64_t replayPasses;
+    uint64_t rejected;
+    uint64_t bytes;
+    double packetsPerSecond;
+    uint64_t sessionsLive;
+    uint64_t sessionsCreated;
+    uint64_t sessionsEvicted;
+    uint64_t lost;
+    uint64_t duplicates;
+    uint64_t outOfOrder;
+    uint64_t flashbacks;
+    uint64_t logWritten;
+    uint64_t logDropped;
+    uint64_t captureBytes;
+    uint64_t relayForwarded;
+    uint64_t relayDropped;
+    uint64_t analysisTicks;
+    double analysisBusy;   // fraction of the analysis thread's time spent working
+};
+
+// Packets in so far: the replay feeds handleDatagram() directly, past the listener's counters
+static uint64_t packetsIn(bool replay) {
+    return replay ? getReplayStats().packets.load(std::memory_order_relaxed)
+                  : getUDPListenerStats().packets.load(std::memory_order_relaxed);
+}
+
+static StatusSample takeSample(bool replay, double uptimeSeconds, uint64_t lastPackets, double elapsedSeconds) {
+    StatusSample s = {};
+    s.uptimeSeconds = uptimeSeconds;
+    s.replay = replay;
+
+    const UDPListenerStats& ingest = getUDPListenerStats();
+    s.packets = packetsIn(replay);
+    s.replayPasses = replay ? getReplayStats().passes.load(std::memory_order_relaxed) : 0;
+    s.rejected = ingest.rejected.load(std::memory_order_relaxed);
+    s.bytes = ingest.bytes.load(std::memory_order_relaxed);
+    s.packetsPerSecond = elapsedSeconds > 0.0 ? (s.packets - lastPackets) / elapsedSeconds : 0.0;
+
+    const SessionRegistryStats& sessions = g_sessions.stats();
+    s.sessionsLive = sessions.active.load(std::memory_order_relaxed);
+    s.sessionsCreated = sessions.created.load(std::memory_order_relaxed);
+    s.sessionsEvicted = sessions.evicted.load(std::memory_order_relaxed);
+
+    const SequenceStats& seq = g_sequenceTracker.stats();
+    for (const SequenceTypeStats& type : seq.types) {
+        s.lost += type.gaps.load(std::memory_order_relaxed);
+        s.duplicates += type.duplicates.load(std::memory_order_relaxed);
+        s.outOfOrder += type.outOfOrder.load(std::memory_order_relaxed);
+    }
+    s.flashbacks = seq.flashbacks.load(std::memory_order_relaxed);
+
+    const AsyncLogStats& log = g_packetLog.stats();
+    s.logWritten = log.written.load(std::memory_order_relaxed);
+    s.logDropped = log.dropped.load(std::memory_order_relaxed);
+    s.captureBytes = log.captureBytes.load(std::memory_order_relaxed);
+
+    for (const RelayTargetStats& relay : g_relay.stats()) {
+        s.relayForwarded += relay.forwarded;
+        s.relayDropped += relay.dropped;
+    }
+
+    const AnalysisStats& analysis = g_analysis.stats();
+    s.analysisTicks = analysis.ticks.load(std::memory_order_relaxed);
+    s.analysisBusy = uptimeSeconds > 0.0 ? analysis.busyNs.load(std::memory_order_relaxed) / (uptimeSeconds * 1e9) : 0.0;
+    return s;
+}
+
+static void printStatus(const StatusSample& s) {
+    char line[320];
+    std::snprintf(line, sizeof(line),
+                  "[%6.0fs] %.0f pkt/s, %llu %s (%llu rejected), %llu sessions live, ~%llu lost, "
+                  "log %llu written / %llu dropped, capture %.1f MB, analysis %.2f%% busy",
+                  s.uptimeSeconds, s.packetsPerSecond, (unsigned long long)s.packets,
+                  s.replay ? "packets replayed" : "packets",
+                  (unsigned long long)s.rejected, (unsigned long long)s.sessionsLive,
+                  (unsigned long long)s.lost, (unsigned long long)s.logWritten,
+                  (unsigned long long)s.logDropped, s.captureBytes / (1024.0 * 1024.0), 100.0 * s.analysisBusy);
+    std::cout << line << std::endl;
+}
+
+static bool writeStatsFile(const std::string& path, const StatusSample& s) {
+    std::string tmp = path + ".tmp";
+    FILE* f = std::fopen(tmp.c_str(), "w");
+    if (!f) return false;
+
+    std::fprintf(f, "{\n");
+    std::fprintf(f, "  \"uptime_s\": %.1f,\n", s.uptimeSeconds);
+    std::fprintf(f, "  \"source\": \"%s\",\n", s.replay ? "replay" : "udp");
+    if (s.replay) {
+        std::fprintf(f, "  \"replay\": {\"passes\": %llu, \"finished\": %s},\n",
+                     (unsigned long long)s.replayPasses, getReplayStats().finished.load() ? "true" : "false");
+    }
+    std::fprintf(f, "  \"packets\": %llu,\n", (unsigned long long)s.packets);
+    std::fprintf(f, "  \"packets_per_s\": %.1f,\n", s.packetsPerSecond);
+    std::fprintf(f, "  \"rejected\": %llu,\n", (unsigned long long)s.rejected);
+    std::fprintf(f, "  \"bytes\": %llu,\n", (unsigned long long)s.bytes);
+    std::fprintf(f, "  \"sessions\": {\"live\": %llu, \"created\": %llu, \"evicted\": %llu},\n",
+                 (unsigned long long)s.sessionsLive, (unsigned long long)s.sessionsCreated,
+                 (unsigned long long)s.sessionsEvicted);
+    std::fprintf(f, "  \"sequence\": {\"lost\": %llu, \"duplicates\": %llu, \"out_of_order\": %llu, \"flashbacks\": %llu},\n",
+                 (unsigned long long)s.lost, (unsigned long long)s.duplicates,
+                 (unsigned long long)s.outOfOrder, (unsigned long long)s.flashbacks);
+    std::fprintf(f, "  \"packet_log\": {\"written\": %llu, \"dropped\": %llu, \"capture_bytes\": %llu},\n",
+                 (unsigned long long)s.logWritten, (unsigned long long)s.logDropped,
+                 (unsigned long long)s.captureBytes);
+    std::fprintf(f, "  \"relay\": {\"forwarded\": %llu, \"dropped\": %llu},\n",
+                 (unsigned long long)s.relayForwarded, (unsigned long long)s.relayDropped);
+    std::fprintf(f, "  \"analysis\": {\"ticks\": %llu, \"busy\": %.4f},\n",
+                 (unsigned long long)s.analysisTicks, s.analysisBusy);
+    std::fprintf(f, "  \"latency_us\": {");
+    for (size_t stage = 0; stage < NUM_LATENCY_STAGES; ++stage) {
+        LatencyHistogram::Summary l = g_latency[stage].summary();
+        std::fprintf(f, "%s\n    \"%s\": {\"p50\": %.1f, \"p99\": %.1f, \"p999\": %.1f, \"max\": %.1f, \"count\": %llu}",
+                     stage ? "," : "", latencyStageName(static_cast<LatencyStage>(stage)),
+                     l.p50Ns / 1000.0, l.p99Ns / 1000.0, l.p999Ns / 1000.0, l.maxNs / 1000.0,
+                     (unsigned long long)l.count);
+    }
+    std::fprintf(f, "\n  }\n}\n");
+
+    bool ok = std::fclose(f) == 0;
+    return ok && std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+void runHeadless(const HeadlessConfig& config) {
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const bool reporting = config.statusIntervalSeconds > 0.0 || !config.statsFile.empty();
+    const double interval = config.statusIntervalSeconds > 0.0 ? config.statusIntervalSeconds : 5.0;
+    Clock::time_point nextReport = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interval));
+    Clock::time_point lastReport = start;
+    uint64_t lastPackets = packetsIn(config.replay);
+    bool statsFileFailed = false;
+
+    std::cout << "Headless: running, Ctrl-C / SIGTERM to stop" << std::endl;
+    while (!g_stopRequested) {
+        if (config.replay && getReplayStats().finished.load()) {
+            std::cout << "Headless: replay finished" << std::endl;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        Clock::time_point now = Clock::now();
+        if (!reporting || now < nextReport) continue;
+
+        StatusSample sample = takeSample(config.replay, std::chrono::duration<double>(now - start).count(), lastPackets,
+                                         std::chrono::duration<double>(now - lastReport).count());
+        lastPackets = sample.packets;
+        lastReport = now;
+        nextReport += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interval));
+        if (nextReport < now) nextReport = now;
+
+        if (config.statusIntervalSeconds > 0.0) printStatus(sample);
+        if (!config.statsFile.empty() && !writeStatsFile(config.statsFile, sample) && !statsFileFailed) {
+            std::cerr << "Failed to write stats file " << config.statsFile << "\n";
+            statsFileFailed = true;
+        }
+    }
+    std::cout << "Headless: stopping" << std::endl;
+    if (!config.statsFile.empty()) {
+        Clock::time_point now = Clock::now();
+        writeStatsFile(config.statsFile, takeSample(config.replay, std::chrono::duration<double>(now - start).count(),
+                                                    lastPackets, std::chrono::duration<double>(now - lastReport).count()));
+    }
+
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <string>
+
+struct HeadlessConfig {
+    double statusIntervalSeconds = 5.0;   // status line period; 0 = none
+    std::string statsFile;                // rewritten every period when set (JSON)
+    bool replay = false;                  // --replay: packets come from the replay, not the listener
+};
+
+// --headless: ingest, capture / text logs, relay, reference laps and analysis run as usual
+// with no window or GL context. Blocks until SIGINT / SIGTERM, printing a one-line status
+// and refreshing the stats file every period; the file is replaced whole (write + rename),
+// so a monitor polling it never reads half of one. A replay that doesn't loop ends the run
+// once it has published its last packet.
+void runHeadless(const HeadlessConfig& config);
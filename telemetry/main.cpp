@@ -1,55 +1,269 @@
+#ifndef F1_HEADLESS
 #include "Visualizer.hpp"
+#include "FramePacer.hpp"
+#endif
+#include "headless.hpp"
+#include "TelemetryAnalysis.hpp"
 #include "udpListener.hpp"
-#include "ReferenceTracker.hpp"
+#include "asyncLogWriter.hpp"
+#include "udpRelay.hpp"
+#include "packetBus.hpp"
+#include "LiveSubscribers.hpp"
+#include "SessionRegistry.hpp"
+#include "latencyHistogram.hpp"
+#include "sequenceTracker.hpp"
+#include "sessionReplay.hpp"
+#include <atomic>
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+
+#ifndef F1_HEADLESS
+// Render loop on the main thread until the window closes. The pacer caps the rate when
+// vsync doesn't (hidden or occluded windows) and otherwise never sleeps, since the swap
+// already waited.
+static bool runVisualizer(double fps) {
+    Visualizer visualizer(1200, 700);
+
+    if (!visualizer.init()) {
+        std::cerr << "Failed to initialize visualizer (no display? --headless runs without one)\n";
+        return false;
+    }
+
+    std::cout << "Visualizer initialized. Waiting for telemetry...\n";
+
+    FramePacer pacer(fps);
+    while (visualizer.update()) {
+        pacer.wait();
+    }
+
+    visualizer.shutdown();
+    std::cout << "Render: " << pacer.iterations() << " frames, " << pacer.late() << " late\n";
+    return true;
+}
+#endif
 
 int main(int argc, char** argv) {
     bool referenceLap = false;
+    double fps = 60.0;
+    AnalysisConfig analysisConfig;
+    bool analysisRateSet = false;
+#ifdef F1_HEADLESS
+    bool headless = true;   // built without the Visualizer
+#else
+    bool headless = false;
+#endif
+    HeadlessConfig headlessConfig;
+    UDPListenerConfig listenerConfig;
+    AsyncLogConfig logConfig;
+    ReplayConfig replayConfig;
+    SessionRegistryConfig sessionConfig;
+    bool fullRateSet = false, tier10HzSet = false, tier1HzSet = false, sparesSet = false;
+    std::string latencyReport;
 
-    if (argc > 1) {
-        std::string arg = argv[1];
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
         if (arg == "--reference-lap") {
             referenceLap = true;
             std::cout << "Tracking this lap as reference for track calibration.\n";
+        } else if (arg == "--fps" && i + 1 < argc) {
+            fps = std::stod(argv[++i]);
+        } else if (arg == "--analysis-hz" && i + 1 < argc) {
+            analysisConfig.rateHz = std::stod(argv[++i]);
+            analysisRateSet = true;
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--status-interval" && i + 1 < argc) {
+            headlessConfig.statusIntervalSeconds = std::stod(argv[++i]);
+        } else if (arg == "--stats-file" && i + 1 < argc) {
+            headlessConfig.statsFile = argv[++i];
+        } else if (arg == "--batch-size" && i + 1 < argc) {
+            listenerConfig.batchSize = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--recv-timeout-ms" && i + 1 < argc) {
+            listenerConfig.recvTimeoutMs = std::stoi(argv[++i]);
+        } else if (arg == "--bind" && i + 1 < argc) {
+            listenerConfig.bindAddress = argv[++i];
+        } else if (arg == "--port" && i + 1 < argc) {
+            listenerConfig.port = static_cast<uint16_t>(std::stoul(argv[++i]));
+        } else if (arg == "--listeners" && i + 1 < argc) {
+            listenerConfig.listeners = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--no-pin") {
+            listenerConfig.pinThreads = false;
+        } else if (arg == "--io-uring") {
+            listenerConfig.ioUring = true;
+            logConfig.ioUring = true;
+        } else if (arg == "--log-queue" && i + 1 < argc) {
+            logConfig.queueCapacity = std::stoul(argv[++i]);
+        } else if (arg == "--log-flush-ms" && i + 1 < argc) {
+            logConfig.flushIntervalMs = std::stoi(argv[++i]);
+        } else if (arg == "--text-logs") {
+            logConfig.textLogs = true;
+        } else if (arg == "--no-capture") {
+            logConfig.capture = false;
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayConfig.path = argv[++i];
+        } else if (arg == "--replay-speed" && i + 1 < argc) {
+            std::string speed = argv[++i];
+            replayConfig.speed = (speed == "max") ? 0.0 : std::stod(speed);
+        } else if (arg == "--replay-loop") {
+            replayConfig.loop = true;
+        } else if (arg == "--history-full" && i + 1 < argc) {
+            sessionConfig.history.fullRateSeconds = std::stod(argv[++i]);
+            fullRateSet = true;
+        } else if (arg == "--history-10hz" && i + 1 < argc) {
+            sessionConfig.history.tier10HzSeconds = std::stod(argv[++i]);
+            tier10HzSet = true;
+        } else if (arg == "--history-1hz" && i + 1 < argc) {
+            sessionConfig.history.tier1HzSeconds = std::stod(argv[++i]);
+            tier1HzSet = true;
+        } else if (arg == "--max-sessions" && i + 1 < argc) {
+            sessionConfig.maxSessions = std::stoul(argv[++i]);
+        } else if (arg == "--spare-sessions" && i + 1 < argc) {
+            sessionConfig.spareSessions = std::stoul(argv[++i]);
+            sparesSet = true;
+        } else if (arg == "--session-idle-s" && i + 1 < argc) {
+            sessionConfig.idleTimeoutSeconds = std::stod(argv[++i]);
+            logConfig.sessionIdleSeconds = sessionConfig.idleTimeoutSeconds;
+        } else if (arg == "--relay" && i + 1 < argc) {
+            RelayTarget target;
+            if (parseRelayTarget(argv[++i], target) && g_relay.addTarget(target)) {
+                std::cout << "Relaying to " << target.spec << "\n";
+            }
+        } else if (arg == "--latency-report" && i + 1 < argc) {
+            latencyReport = argv[++i];
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n";
         }
     }
 
-    // Start UDP listener in background thread
-    std::thread listenerThread(startUDPListener);
-    listenerThread.detach();
+    const bool replay = !replayConfig.path.empty();
+    headlessConfig.replay = replay;
+    if (replay) {
+        // Don't re-record a session we are replaying
+        logConfig.capture = false;
+    }
+
+    if (headless) {
+        // Nothing draws the session history: size the stores for reference laps and the
+        // stats, not for plots, unless the command line says otherwise
+        if (!fullRateSet) sessionConfig.history.fullRateSeconds = 10;
+        if (!tier10HzSet) sessionConfig.history.tier10HzSeconds = 60;
+        if (!tier1HzSet) sessionConfig.history.tier1HzSeconds = 10 * 60;
+        if (!sparesSet) sessionConfig.spareSessions = 1;
+    }
+
+    // Size each session's live stores, then subscribe consumers before ingest starts;
+    // the listener / replay only publishes. Relay first, so forwarded packets don't wait
+    // on local processing.
+    g_sessions.configure(sessionConfig);
+    std::cout << "Sessions: up to " << sessionConfig.maxSessions << " live, " << sessionConfig.spareSessions
+              << " prepared ahead" << std::endl;
+    g_relay.attach(g_packetBus);
+    subscribeLiveViews(g_packetBus);
 
-    // Give the listener a moment to bind to the socket
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    // Capture / text logs are written on their own thread, fed from the bus
+    g_packetLog.start(logConfig);
+    g_packetLog.attach(g_packetBus);
+
+    if (replay) {
+        // Replay drives the same dispatch path as the listener, no game needed
+        std::thread replayThread([replayConfig]() { runSessionReplay(replayConfig); });
+        replayThread.detach();
+    } else {
+        // Start UDP listener in background thread; it only returns if it couldn't bind
+        static std::atomic<bool> listenerFailed{false};
+        std::thread listenerThread([listenerConfig]() {
+            startUDPListener(listenerConfig);
+            listenerFailed.store(true);
+        });
+        listenerThread.detach();
+
+        // Wait for the sockets to be bound (or not), at most 500 ms
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+        while (getUDPListenerStats().listeners.load() == 0 && !listenerFailed.load() &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (headless && listenerFailed.load()) {
+            // Nothing else to show for it without a window
+            std::cerr << "UDP listener failed to start\n";
+            return 1;
+        }
+    }
 
     if(referenceLap) {
         std::cout << "Reference lap mode enabled. Use the track calibration tool after completing the lap.\n";
     }
 
-    Visualizer visualizer(1200, 700);
-    ReferenceTracker refTracker;
+    // Reference tracking and the Driver Inputs analysis run on their own thread, so they
+    // keep up whatever the render loop is doing. Headless, only reference laps need it.
+    analysisConfig.referenceLaps = referenceLap;
+    if (headless && !analysisRateSet) analysisConfig.rateHz = 20.0;
+    g_analysis.start(analysisConfig);
 
-    if (!visualizer.init()) {
-        std::cerr << "Failed to initialize visualizer\n";
-        return 1;
+    if (headless) {
+        runHeadless(headlessConfig);
+    } else {
+#ifndef F1_HEADLESS
+        if (!runVisualizer(fps)) return 1;
+#else
+        (void)fps;
+#endif
     }
 
-    std::cout << "Visualizer initialized. Waiting for telemetry...\n";
+    // Saves the reference laps
+    g_analysis.stop();
 
-    // Main loop
-    while (visualizer.update()) {
-        if(referenceLap) {
-            refTracker.update();
+    const AnalysisStats& analysis = g_analysis.stats();
+    std::cout << "Analysis: " << analysis.ticks.load() << " passes (" << analysis.late.load() << " late), "
+              << analysis.published.load() << " snapshots, " << analysis.replaced.load()
+              << " replaced unread\n";
+
+    const UDPListenerStats& stats = getUDPListenerStats();
+    std::cout << "Ingest: " << stats.packets.load() << " packets in " << stats.syscalls.load()
+              << " receive syscalls (" << stats.packetsPerSyscall() << " packets/syscall, max batch "
+              << stats.maxBatch.load() << ")\n";
+    if (stats.uringListeners.load() > 0) {
+        std::cout << "  io_uring: " << stats.uringListeners.load() << " listeners, "
+                  << stats.bufferStalls.load() << " buffer stalls\n";
+    }
+    if (stats.listeners.load() > 1) {
+        std::cout << "  per listener:";
+        for (uint64_t i = 0; i < stats.listeners.load(); ++i) {
+            std::cout << " " << stats.perListener[i].load();
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));  // ~60 FPS
+        std::cout << "\n";
     }
-
-    if(referenceLap) {
-        refTracker.saveReferenceLap();
+    const SequenceStats& seq = g_sequenceTracker.stats();
+    uint64_t lost = 0, duplicates = 0, outOfOrder = 0;
+    for (const SequenceTypeStats& type : seq.types) {
+        lost += type.gaps.load();
+        duplicates += type.duplicates.load();
+        outOfOrder += type.outOfOrder.load();
+    }
+    const SessionRegistryStats& sessions = g_sessions.stats();
+    std::cout << "Sessions: " << sessions.created.load() << " created, " << sessions.evicted.load()
+              << " evicted, " << sessions.builtInline.load() << " built on the ingest thread\n";
+    std::cout << "Sequence: ~" << lost << " lost, " << duplicates << " duplicate, " << outOfOrder
+              << " out of order, " << seq.flashbacks.load() << " flashbacks\n";
+    for (const RelayTargetStats& relay : g_relay.stats()) {
+        std::cout << "Relay " << relay.spec << ": " << relay.forwarded << " forwarded, " << relay.decimated
+                  << " rate limited, " << relay.dropped << " dropped (backed up), " << relay.errors << " errors\n";
+    }
+    if (!latencyReport.empty() && writeLatencyReport(latencyReport)) {
+        std::cout << "Latency report written to " << latencyReport << "\n";
     }
 
-    visualizer.shutdown();
-    std::cout << "Visualizer closed.\n";
+    g_packetBus.stop();
+    g_packetLog.stop();
+    const AsyncLogStats& logStats = g_packetLog.stats();
+    std::cout << "Packet log: " << logStats.written.load() << " written, " << logStats.dropped.load()
+              << " dropped (queue high water " << logStats.highWater.load() << ", "
+              << logStats.flushes.load() << " flushes, " << logStats.captureBytes.load()
+              << " capture bytes)\n";
+    std::cout << (headless ? "Stopped.\n" : "Visualizer closed.\n");
     return 0;
 }
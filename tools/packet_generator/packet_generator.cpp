@@ -0,0 +1,786 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <time.h>
+#include "../../core/packetStructs.hpp"
+#include "../../core/packetWriters.hpp"
+#include "../../core/udpListener.hpp"
+#include "../../core/asyncLogWriter.hpp"
+#include "../../core/udpRelay.hpp"
+#include "../../core/packetBus.hpp"
+#include "../../core/latencyHistogram.hpp"
+#include "../../core/sequenceTracker.hpp"
+#include "../../live/LiveTelemetry.hpp"
+#include "../../live/LiveSubscribers.hpp"
+#include "../../live/FrameAssembler.hpp"
+#include "../../live/SessionRegistry.hpp"
+
+// Synthetic F1 23 packet generator.
+//
+//   packet_generator [--host 127.0.0.1] [--port 20777] [--rate 60] [--duration 10]
+//       Send a plausible 22-car session to a running telemetry_viz at --rate frames/s.
+//
+//   packet_generator --harness [--rate 60 | --sweep] [--duration 5] [--no-capture]
+//                    [--latency-report FILE] [--listeners K] [--rigs N] [--io-uring] [--relay SPEC]...
+//       Run startUDPListener() in-process (K SO_REUSEPORT sockets) and measure packet loss, ingest latency and
+//       CPU per packet at each rate. --sweep steps from 60 Hz to 10 kHz to find saturation.
+//       Also prints the listener's own kernel-receive -> decode / ring push histograms.
+//       --io-uring runs the listener and the capture writer on io_uring to compare syscalls / packet.
+//       --relay forwards from the listener as telemetry_viz --relay does, to measure what it costs ingest.
+//
+// --rigs N sends every packet from N sockets, each as its own session (session UID + i),
+// like N games on one network; the harness checks each got its own live session.
+//
+// Every frame carries motion, car telemetry, lap data, car status and motion-ex packets;
+// session and car damage go out every 30 frames, participants and setups every 300.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kNumCars = 22;
+constexpr float kPi = 3.14159265f;
+
+// ===================== TRACK =====================
+
+struct TrackPoint {
+    float x, z;
+    float distance;    // metres from the start line
+    float curvature;   // 1/m
+};
+
+// Closed Catmull-Rom spline through a handful of control points, resampled by arc length
+class Track {
+public:
+    Track() {
+        const float ctrl[][2] = {
+            {0, 0}, {600, -20}, {900, 150}, {850, 420}, {600, 480}, {420, 330},
+            {200, 380}, {-80, 560}, {-350, 420}, {-300, 150}, {-420, -60}, {-200, -120}
+        };
+        const int n = sizeof(ctrl) / sizeof(ctrl[0]);
+        const int steps = 200;
+
+        std::vector<std::array<float, 2>> dense;
+        for (int i = 0; i < n; ++i) {
+            const float* p0 = ctrl[(i + n - 1) % n];
+            const float* p1 = ctrl[i];
+            const float* p2 = ctrl[(i + 1) % n];
+            const float* p3 = ctrl[(i + 2) % n];
+            for (int s = 0; s < steps; ++s) {
+                float t = static_cast<float>(s) / steps;
+                float t2 = t * t, t3 = t2 * t;
+                std::array<float, 2> p;
+                for (int k = 0; k < 2; ++k) {
+                    p[k] = 0.5f * ((2 * p1[k]) + (-p0[k] + p2[k]) * t +
+                                   (2 * p0[k] - 5 * p1[k] + 4 * p2[k] - p3[k]) * t2 +
+                                   (-p0[k] + 3 * p1[k] - 3 * p2[k] + p3[k]) * t3);
+                }
+                dense.push_back(p);
+            }
+        }
+
+        float dist = 0;
+        for (size_t i = 0; i < dense.size(); ++i) {
+            if (i > 0) dist += std::hypot(dense[i][0] - dense[i - 1][0], dense[i][1] - dense[i - 1][1]);
+            points_.push_back({dense[i][0], dense[i][1], dist, 0.0f});
+        }
+        length_ = dist + std::hypot(dense.front()[0] - dense.back()[0], dense.front()[1] - dense.back()[1]);
+
+        // Curvature from the turning angle between neighbouring segments
+        const size_t m = points_.size();
+        for (size_t i = 0; i < m; ++i) {
+            const TrackPoint& a = points_[(i + m - 1) % m];
+            const TrackPoint& b = points_[i];
+            const TrackPoint& c = points_[(i + 1) % m];
+            float h1 = std::atan2(b.z - a.z, b.x - a.x);
+            float h2 = std::atan2(c.z - b.z, c.x - b.x);
+            float dh = std::remainder(h2 - h1, 2 * kPi);
+            float ds = std::max(0.1f, std::hypot(c.x - a.x, c.z - a.z) * 0.5f);
+            points_[i].curvature = dh / ds;
+        }
+    }
+
+    float length() const { return length_; }
+
+    const TrackPoint& at(float distance) const {
+        float d = std::fmod(distance, length_);
+        if (d < 0) d += length_;
+        size_t idx = static_cast<size_t>(d / length_ * points_.size());
+        return points_[std::min(idx, points_.size() - 1)];
+    }
+
+    // Cornering speed limit at a point, looking ahead so cars brake before the corner
+    float targetSpeed(float distance) const {
+        float v = 92.0f;   // ~330 km/h
+        for (float ahead = 0; ahead <= 250.0f; ahead += 10.0f) {
+            float k = std::fabs(at(distance + ahead).curvature);
+            float corner = k > 1e-4f ? std::sqrt(35.0f / k) : 92.0f;   // ~3.5 g lateral
+            // v^2 = corner^2 + 2 * decel * ahead
+            v = std::min(v, std::sqrt(corner * corner + 2.0f * 40.0f * ahead));
+        }
+        return v;
+    }
+
+private:
+    std::vector<TrackPoint> points_;
+    float length_ = 0;
+};
+
+// ===================== CARS =====================
+
+struct CarState {
+    float distance = 0;     // total distance travelled
+    float speed = 0;        // m/s
+    float throttle = 0;
+    float brake = 0;
+    float steer = 0;
+    int lap = 1;
+    float lapTime = 0;
+    float lastLapTime = 0;
+    float fuel = 100.0f;
+    float skill = 1.0f;     // scales corner speed so cars spread out
+};
+
+struct Simulation {
+    Track track;
+    std::array<CarState, kNumCars> cars;
+    uint64_t sessionUID = 0x5eed5eed5eed5eedull;
+    uint32_t frame = 0;
+    float sessionTime = 0;
+
+    Simulation() {
+        for (int i = 0; i < kNumCars; ++i) {
+            cars[i].distance = -8.0f * i;   // grid
+            cars[i].skill = 1.0f - 0.004f * i;
+        }
+    }
+
+    void step(float dt) {
+        for (CarState& car : cars) {
+            float target = track.targetSpeed(car.distance) * car.skill;
+            if (car.speed < target) {
+                car.throttle = 1.0f;
+                car.brake = 0.0f;
+                car.speed = std::min(target, car.speed + 11.0f * dt);
+            } else {
+                car.throttle = 0.0f;
+                car.brake = std::min(1.0f, (car.speed - target) / 8.0f);
+                car.speed = std::max(target, car.speed - 40.0f * car.brake * dt);
+            }
+            car.steer = std::max(-1.0f, std::min(1.0f, track.at(car.distance).curvature * 40.0f));
+
+            float before = car.distance;
+            car.distance += car.speed * dt;
+            car.lapTime += dt;
+            if (std::floor(car.distance / track.length()) > std::floor(before / track.length())) {
+                car.lastLapTime = car.lapTime;
+                car.lapTime = 0;
+                ++car.lap;
+            }
+            car.fuel = std::max(0.0f, car.fuel - 0.0004f * car.throttle);
+        }
+        ++frame;
+    }
+
+    int racePosition(int carIdx) const {
+        int pos = 1;
+        for (int i = 0; i < kNumCars; ++i) {
+            if (cars[i].distance > cars[carIdx].distance) ++pos;
+        }
+        return pos;
+    }
+};
+
+void fillHeader(PacketHeader& h, const Simulation& sim, uint8_t packetId) {
+    h.m_packetFormat = 2023;
+    h.m_gameYear = 23;
+    h.m_gameMajorVersion = 1;
+    h.m_gameMinorVersion = 18;
+    h.m_packetVersion = 1;
+    h.m_packetId = packetId;
+    h.m_sessionUID = sim.sessionUID;
+    h.m_sessionTime = sim.sessionTime;
+    h.m_frameIdentifier = sim.frame;
+    h.m_overallFrameIdentifier = sim.frame;
+    h.m_playerCarIndex = 0;
+    h.m_secondaryPlayerCarIndex = 255;
+}
+
+int gearForSpeed(float speed) {
+    const float kmh = speed * 3.6f;
+    const float top[] = {80, 120, 155, 190, 225, 260, 295};
+    for (int g = 0; g < 7; ++g) {
+        if (kmh < top[g]) return g + 1;
+    }
+    return 8;
+}
+
+// ===================== PACKET BUILDERS =====================
+
+class PacketBuilder {
+public:
+    explicit PacketBuilder(const Simulation& sim) : sim_(sim) {}
+
+    PacketMotionData& motion() {
+        std::memset(&motion_, 0, sizeof(motion_));
+        fillHeader(motion_.m_header, sim_, MOTION);
+        for (int i = 0; i < kNumCars; ++i) {
+            const CarState& car = sim_.cars[i];
+            const TrackPoint& p = sim_.track.at(car.distance);
+            const TrackPoint& next = sim_.track.at(car.distance + 1.0f);
+            float heading = std::atan2(next.z - p.z, next.x - p.x);
+            CarMotionData& m = motion_.m_carMotionData[i];
+            m.m_worldPositionX = p.x;
+            m.m_worldPositionY = 0.0f;
+            m.m_worldPositionZ = p.z;
+            m.m_worldVelocityX = std::cos(heading) * car.speed;
+            m.m_worldVelocityZ = std::sin(heading) * car.speed;
+            m.m_worldForwardDirX = static_cast<int16_t>(std::cos(heading) * 32767);
+            m.m_worldForwardDirZ = static_cast<int16_t>(std::sin(heading) * 32767);
+            m.m_gForceLateral = car.speed * car.speed * p.curvature / 9.81f;
+            m.m_gForceLongitudinal = car.throttle * 1.2f - car.brake * 4.5f;
+            m.m_gForceVertical = 1.0f;
+            m.m_yaw = heading;
+        }
+        return motion_;
+    }
+
+    PacketCarTelemetryData& telemetry() {
+        std::memset(&telemetry_, 0, sizeof(telemetry_));
+        fillHeader(telemetry_.m_header, sim_, CAR_TELEMETRY);
+        for (int i = 0; i < kNumCars; ++i) {
+            const CarState& car = sim_.cars[i];
+            CarTelemetryData& t = telemetry_.m_carTelemetryData[i];
+            int gear = gearForSpeed(car.speed);
+            float kmh = car.speed * 3.6f;
+            t.m_speed = static_cast<uint16_t>(kmh);
+            t.m_throttle = car.throttle;
+            t.m_steer = car.steer;
+            t.m_brake = car.brake;
+            t.m_clutch = 0;
+            t.m_gear = static_cast<int8_t>(gear);
+            t.m_engineRPM = static_cast<uint16_t>(std::min(12000.0f, 4000.0f + std::fmod(kmh, 35.0f) / 35.0f * 7500.0f));
+            t.m_drs = (kmh > 280.0f && car.throttle > 0.99f) ? 1 : 0;
+            t.m_revLightsPercent = static_cast<uint8_t>((t.m_engineRPM - 4000) * 100 / 8000);
+            t.m_revLightsBitValue = static_cast<uint16_t>((1u << (t.m_revLightsPercent * 15 / 100)) - 1);
+            t.m_engineTemperature = 105;
+            for (int w = 0; w < 4; ++w) {
+                t.m_brakesTemperature[w] = static_cast<uint16_t>(300 + 600 * car.brake);
+                t.m_tyresSurfaceTemperature[w] = 95;
+                t.m_tyresInnerTemperature[w] = 100;
+                t.m_tyresPressure[w] = w < 2 ? 21.0f : 23.5f;   // RL, RR, FL, FR
+            }
+        }
+        telemetry_.m_mfdPanelIndex = 255;
+        telemetry_.m_mfdPanelIndexSecondaryPlayer = 255;
+        return telemetry_;
+    }
+
+    PacketLapData& lapData() {
+        std::memset(&lap_, 0, sizeof(lap_));
+        fillHeader(lap_.m_header, sim_, LAP_DATA);
+        for (int i = 0; i < kNumCars; ++i) {
+            const CarState& car = sim_.cars[i];
+            LapData& l = lap_.m_lapData[i];
+            l.m_lastLapTimeInMS = static_cast<uint32_t>(car.lastLapTime * 1000);
+            l.m_currentLapTimeInMS = static_cast<uint32_t>(car.lapTime * 1000);
+            l.m_lapDistance = std::fmod(std::max(0.0f, car.distance), sim_.track.length());
+            l.m_totalDistance = car.distance;
+            l.m_carPosition = static_cast<uint8_t>(sim_.racePosition(i));
+            l.m_currentLapNum = static_cast<uint8_t>(car.lap);
+            l.m_sector = static_cast<uint8_t>(std::min(2.0f, l.m_lapDistance / sim_.track.length() * 3));
+            l.m_gridPosition = static_cast<uint8_t>(i + 1);
+            l.m_driverStatus = 4;
+            l.m_resultStatus = 2;
+        }
+        lap_.m_timeTrialPBCarIdx = 255;
+        lap_.m_timeTrialRivalCarIdx = 255;
+        return lap_;
+    }
+
+    PacketCarStatusData& carStatus() {
+        std::memset(&status_, 0, sizeof(status_));
+        fillHeader(status_.m_header, sim_, CAR_STATUS);
+        for (int i = 0; i < kNumCars; ++i) {
+            CarStatusData& s = status_.m_carStatusData[i];
+            s.m_fuelInTank = sim_.cars[i].fuel;
+            s.m_fuelCapacity = 110.0f;
+            s.m_fuelRemainingLaps = sim_.cars[i].fuel / 1.6f;
+            s.m_maxRPM = 12000;
+            s.m_idleRPM = 4000;
+            s.m_maxGears = 8;
+            s.m_drsAllowed = 1;
+            s.m_actualTyreCompound = 18;
+            s.m_visualTyreCompound = 17;
+            s.m_ersStoreEnergy = 4.0e6f;
+        }
+        return status_;
+    }
+
+    PacketMotionExData& motionEx() {
+        std::memset(&motionEx_, 0, sizeof(motionEx_));
+        fillHeader(motionEx_.m_header, sim_, MOTION_EX);
+        const CarState& car = sim_.cars[0];
+        for (int w = 0; w < 4; ++w) {
+            motionEx_.m_wheelSpeed[w] = car.speed;
+            motionEx_.m_wheelVertForce[w] = 4000.0f;
+        }
+        motionEx_.m_localVelocityZ = car.speed;
+        motionEx_.m_frontWheelsAngle = car.steer * 0.3f;
+        motionEx_.m_heightOfCOGAboveGround = 0.28f;
+        return motionEx_;
+    }
+
+    PacketSessionData& session() {
+        std::memset(&session_, 0, sizeof(session_));
+        fillHeader(session_.m_header, sim_, SESSION);
+        session_.m_weather = 0;
+        session_.m_trackTemperature = 34;
+        session_.m_airTemperature = 26;
+        session_.m_totalLaps = 57;
+        session_.m_trackLength = static_cast<uint16_t>(sim_.track.length());
+        session_.m_sessionType = 10;
+        session_.m_trackId = 3;
+        session_.m_sessionDuration = 7200;
+        session_.m_sessionTimeLeft = static_cast<uint16_t>(std::max(0.0f, 7200 - sim_.sessionTime));
+        session_.m_pitSpeedLimit = 80;
+        return session_;
+    }
+
+    PacketCarDamageData& carDamage() {
+        std::memset(&damage_, 0, sizeof(damage_));
+        fillHeader(damage_.m_header, sim_, CAR_DAMAGE);
+        for (int i = 0; i < kNumCars; ++i) {
+            for (int w = 0; w < 4; ++w) {
+                damage_.m_carDamageData[i].m_tyresWear[w] = std::min(100.0f, sim_.cars[i].distance / 1000.0f);
+            }
+        }
+        return damage_;
+    }
+
+    PacketParticipantsData& participants() {
+        std::memset(&participants_, 0, sizeof(participants_));
+        fillHeader(participants_.m_header, sim_, PARTICIPANTS);
+        participants_.m_numActiveCars = kNumCars;
+        for (int i = 0; i < kNumCars; ++i) {
+            ParticipantData& p = participants_.m_participants[i];
+            p.m_aiControlled = i == 0 ? 0 : 1;
+            p.m_teamId = static_cast<uint8_t>(i / 2);
+            p.m_raceNumber = static_cast<uint8_t>(i + 1);
+            std::snprintf(p.m_name, sizeof(p.m_name), "DRIVER %02d", i + 1);
+        }
+        return participants_;
+    }
+
+    PacketCarSetupData& carSetups() {
+        std::memset(&setups_, 0, sizeof(setups_));
+        fillHeader(setups_.m_header, sim_, CAR_SETUPS);
+        for (int i = 0; i < kNumCars; ++i) {
+            setups_.m_carSetups[i].m_frontWing = 25;
+            setups_.m_carSetups[i].m_rearWing = 20;
+            setups_.m_carSetups[i].m_brakeBias = 56;
+            setups_.m_carSetups[i].m_fuelLoad = 100.0f;
+        }
+        return setups_;
+    }
+
+private:
+    const Simulation& sim_;
+    PacketMotionData motion_;
+    PacketCarTelemetryData telemetry_;
+    PacketLapData lap_;
+    PacketCarStatusData status_;
+    PacketMotionExData motionEx_;
+    PacketSessionData session_;
+    PacketCarDamageData damage_;
+    PacketParticipantsData participants_;
+    PacketCarSetupData setups_;
+};
+
+// ===================== SENDER =====================
+
+struct Options {
+    std::string host = "127.0.0.1";
+    int port = 20777;
+    double rate = 60.0;        // frames per second
+    double duration = 10.0;    // seconds per run
+    bool harness = false;
+    bool sweep = false;
+    bool capture = true;
+    std::string latencyReport;   // harness: write the pipeline latency histograms here
+    unsigned listeners = 1;      // harness: SO_REUSEPORT listener sockets
+    unsigned rigs = 1;           // sending sockets, one session each
+    bool ioUring = false;        // harness: io_uring receive and capture backend
+    std::vector<std::string> relays;   // harness: relay targets, as telemetry_viz --relay
+};
+
+// One socket per rig; rig i sends every packet with m_sessionUID + i
+class Sender {
+public:
+    Sender(const std::string& host, int port, unsigned rigs = 1) {
+        for (unsigned i = 0; i < std::max(1u, rigs); ++i) {
+            int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+            if (sock < 0) break;
+            socks_.push_back(sock);
+        }
+        addr_.sin_family = AF_INET;
+        addr_.sin_port = htons(static_cast<uint16_t>(port));
+        inet_pton(AF_INET, host.c_str(), &addr_.sin_addr);
+    }
+    ~Sender() { for (int sock : socks_) close(sock); }
+
+    bool ok() const { return !socks_.empty(); }
+
+    template<typename T>
+    void send(const T& packet) {
+        if (socks_.size() == 1) {
+            sendFrom(socks_[0], packet);
+            return;
+        }
+        T copy = packet;
+        for (size_t rig = 0; rig < socks_.size(); ++rig) {
+            copy.m_header.m_sessionUID = packet.m_header.m_sessionUID + rig;
+            sendFrom(socks_[rig], copy);
+        }
+    }
+
+    uint64_t sent() const { return sent_; }
+    uint64_t failed() const { return failed_; }
+
+private:
+    template<typename T>
+    void sendFrom(int sock, const T& packet) {
+        if (sendto(sock, &packet, sizeof(T), 0, reinterpret_cast<const sockaddr*>(&addr_), sizeof(addr_)) == sizeof(T)) {
+            ++sent_;
+        } else {
+            ++failed_;
+        }
+    }
+
+    std::vector<int> socks_;
+    sockaddr_in addr_{};
+    uint64_t sent_ = 0;
+    uint64_t failed_ = 0;
+};
+
+// Wait until `due`, sleeping while far away and spinning for the last stretch
+void waitUntil(Clock::time_point due) {
+    auto now = Clock::now();
+    if (due - now > std::chrono::microseconds(300)) {
+        std::this_thread::sleep_until(due - std::chrono::microseconds(200));
+    }
+    while (Clock::now() < due) {
+        std::this_thread::yield();
+    }
+}
+
+double threadCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+double processCpuSeconds() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 +
+           usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+}
+
+// Session time the harness stamps on frame N. Kept on a 1 ms grid (offset by half a tick so
+// the listener's truncation to timestampMs lands exactly on N) which lets the latency probe
+// map each live sample back to the frame it came from.
+float harnessSessionTime(uint32_t frame) {
+    return (frame + 0.5f) * 0.001f;
+}
+
+struct RunResult {
+    double rate = 0;
+    uint64_t frames = 0;
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    uint64_t telemetrySent = 0;
+    uint64_t telemetryLive = 0;
+    double sendSeconds = 0;
+    double cpuPerPacketUs = 0;
+    std::vector<double> latenciesUs;
+};
+
+// Send at `rate` frames/s for `duration`; in harness mode also probe ingest latency
+RunResult runGenerator(const Options& opt, double rate, Simulation& sim, Sender& sender) {
+    RunResult result;
+    result.rate = rate;
+
+    PacketBuilder builder(sim);
+    const uint64_t frames = static_cast<uint64_t>(rate * opt.duration);
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+    const float dt = static_cast<float>(1.0 / rate);
+
+    // Send timestamps by frame, for the latency probe
+    std::vector<std::atomic<int64_t>> sendNs(opt.harness ? sim.frame + frames + 1 : 0);
+    std::atomic<bool> probing{opt.harness};
+    std::vector<double>& latencies = result.latenciesUs;
+    double probeCpu = 0.0;
+
+    std::thread probe;
+    if (opt.harness) {
+        probe = std::thread([&]() {
+            // Follows rig 0's session
+            const SessionKey key = {htonl(INADDR_LOOPBACK), sim.sessionUID};
+            std::shared_ptr<LiveSession> session;
+            uint64_t lastTs = UINT64_MAX;
+            LiveInputSample sample;
+            while (probing.load(std::memory_order_relaxed)) {
+                if (!session) {
+                    session = g_sessions.find(key);
+                    if (!session) continue;
+                }
+                if (session->player.peekLatest(sample) && sample.timestampMs != lastTs) {
+                    lastTs = sample.timestampMs;
+                    int64_t now = Clock::now().time_since_epoch().count();
+                    if (sample.timestampMs < sendNs.size()) {
+                        int64_t sent = sendNs[sample.timestampMs].load(std::memory_order_acquire);
+                        if (sent > 0) latencies.push_back((now - sent) / 1000.0);
+                    }
+                }
+            }
+            probeCpu = threadCpuSeconds();
+        });
+    }
+
+    const UDPListenerStats& stats = getUDPListenerStats();
+    uint64_t receivedBefore = stats.packets.load();
+    uint64_t sentBefore = sender.sent();
+    double cpuBefore = processCpuSeconds();
+    double senderCpuBefore = threadCpuSeconds();
+
+    auto start = Clock::now();
+    auto wallStart = Clock::now();
+    for (uint64_t f = 0; f < frames; ++f) {
+        waitUntil(start + period * static_cast<Clock::rep>(f));
+
+        sim.step(dt);
+        sim.sessionTime = opt.harness ? harnessSessionTime(sim.frame)
+                                      : std::chrono::duration<float>(Clock::now() - wallStart).count();
+
+        sender.send(builder.motion());
+        if (opt.harness) {
+            sendNs[sim.frame].store(Clock::now().time_since_epoch().count(), std::memory_order_release);
+        }
+        sender.send(builder.telemetry());
+        ++result.telemetrySent;
+        sender.send(builder.lapData());
+        sender.send(builder.carStatus());
+        sender.send(builder.motionEx());
+        if (sim.frame % 30 == 0) {
+            sender.send(builder.session());
+            sender.send(builder.carDamage());
+        }
+        if (sim.frame % 300 == 1) {
+            sender.send(builder.participants());
+            sender.send(builder.carSetups());
+        }
+    }
+    result.sendSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    double senderCpu = threadCpuSeconds() - senderCpuBefore;
+
+    if (opt.harness) {
+        // Let the listener drain whatever is still queued in the socket
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        probing.store(false);
+        probe.join();
+    }
+
+    result.frames = frames;
+    result.sent = sender.sent() - sentBefore;
+    result.received = stats.packets.load() - receivedBefore;
+    if (opt.harness) {
+        // Listener + log writer CPU: everything the process burned except the sender and the probe
+        double total = processCpuSeconds() - cpuBefore;
+        double ingestCpu = std::max(0.0, total - senderCpu - probeCpu);
+        result.cpuPerPacketUs = result.received ? ingestCpu / result.received * 1e6 : 0.0;
+    }
+    return result;
+}
+
+double percentile(std::vector<double>& v, double p) {
+    if (v.empty()) return 0.0;
+    size_t idx = static_cast<size_t>(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + idx, v.end());
+    return v[idx];
+}
+
+void printResultHeader() {
+    std::cout << std::left << std::setw(10) << "rate_hz" << std::setw(12) << "pkts/s" << std::setw(10) << "sent"
+              << std::setw(10) << "recv" << std::setw(9) << "loss%" << std::setw(11) << "p50_us"
+              << std::setw(11) << "p99_us" << std::setw(11) << "max_us" << std::setw(12) << "cpu_us/pkt"
+              << "\n";
+}
+
+void printResult(RunResult& r) {
+    double loss = r.sent ? 100.0 * (1.0 - static_cast<double>(r.received) / r.sent) : 0.0;
+    double maxLatency = r.latenciesUs.empty() ? 0.0 : *std::max_element(r.latenciesUs.begin(), r.latenciesUs.end());
+    std::cout << std::left << std::fixed << std::setprecision(1)
+              << std::setw(10) << r.rate << std::setw(12) << r.sent / r.sendSeconds
+              << std::setw(10) << r.sent << std::setw(10) << r.received
+              << std::setprecision(2) << std::setw(9) << loss
+              << std::setprecision(1) << std::setw(11) << percentile(r.latenciesUs, 0.50)
+              << std::setw(11) << percentile(r.latenciesUs, 0.99) << std::setw(11) << maxLatency
+              << std::setprecision(2) << std::setw(12) << r.cpuPerPacketUs << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--host" && i + 1 < argc) opt.host = argv[++i];
+        else if (arg == "--port" && i + 1 < argc) opt.port = std::atoi(argv[++i]);
+        else if (arg == "--rate" && i + 1 < argc) opt.rate = std::atof(argv[++i]);
+        else if (arg == "--duration" && i + 1 < argc) opt.duration = std::atof(argv[++i]);
+        else if (arg == "--harness") opt.harness = true;
+        else if (arg == "--sweep") opt.sweep = true;
+        else if (arg == "--no-capture") opt.capture = false;
+        else if (arg == "--latency-report" && i + 1 < argc) opt.latencyReport = argv[++i];
+        else if (arg == "--listeners" && i + 1 < argc) opt.listeners = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (arg == "--rigs" && i + 1 < argc) opt.rigs = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (arg == "--io-uring") opt.ioUring = true;
+        else if (arg == "--relay" && i + 1 < argc) opt.relays.push_back(argv[++i]);
+        else {
+            std::cerr << "Usage: packet_generator [--host H] [--port P] [--rate HZ] [--duration S] [--rigs N]\n"
+                      << "                        [--harness [--sweep] [--no-capture] [--latency-report FILE]\n"
+                      << "                                   [--listeners K] [--io-uring] [--relay SPEC]...]\n";
+            return 1;
+        }
+    }
+
+    if (opt.rate <= 0 || opt.duration <= 0) {
+        std::cerr << "Rate and duration must be positive\n";
+        return 1;
+    }
+
+    if (opt.harness) {
+        // In-process ingest path: listener thread + log writer, exactly as telemetry_viz runs them
+        opt.host = "127.0.0.1";
+        opt.port = 20777;
+        AsyncLogConfig logConfig;
+        logConfig.capture = opt.capture;
+        logConfig.directory = "loadtest_data";
+        logConfig.ioUring = opt.ioUring;
+        SessionRegistryConfig sessionConfig;
+        sessionConfig.maxSessions = std::max(sessionConfig.maxSessions, static_cast<size_t>(opt.rigs));
+        sessionConfig.spareSessions = std::max(sessionConfig.spareSessions, static_cast<size_t>(opt.rigs));
+        g_sessions.configure(sessionConfig);
+        for (const std::string& spec : opt.relays) {
+            RelayTarget target;
+            if (!parseRelayTarget(spec, target) || !g_relay.addTarget(target)) return 1;
+        }
+        g_relay.attach(g_packetBus);
+        subscribeLiveViews(g_packetBus);
+        g_packetLog.start(logConfig);
+        g_packetLog.attach(g_packetBus);
+        UDPListenerConfig listenerConfig;
+        listenerConfig.listeners = opt.listeners;
+        listenerConfig.ioUring = opt.ioUring;
+        std::thread listener([listenerConfig]() { startUDPListener(listenerConfig); });
+        listener.detach();
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    }
+
+    Sender sender(opt.host, opt.port, opt.rigs);
+    if (!sender.ok()) {
+        std::cerr << "Failed to create socket\n";
+        return 1;
+    }
+
+    Simulation sim;
+    std::vector<double> rates;
+    if (opt.sweep) rates = {60, 120, 240, 480, 1000, 2000, 5000, 10000};
+    else rates = {opt.rate};
+
+    if (!opt.harness) {
+        std::cout << "Sending to " << opt.host << ":" << opt.port << " at " << opt.rate
+                  << " frames/s for " << opt.duration << " s (track length " << sim.track.length() << " m)\n";
+        RunResult r = runGenerator(opt, opt.rate, sim, sender);
+        std::cout << "Sent " << r.sent << " packets (" << r.sent / r.sendSeconds << " packets/s), "
+                  << sender.failed() << " send failures\n";
+        return 0;
+    }
+
+    printResultHeader();
+    for (double rate : rates) {
+        RunResult r = runGenerator(opt, rate, sim, sender);
+        printResult(r);
+    }
+
+    std::cout << "Pipeline latency from kernel receive (us, all runs):\n";
+    for (size_t stage = 0; stage < NUM_LATENCY_STAGES; ++stage) {
+        LatencyHistogram::Summary s = g_latency[stage].summary();
+        if (s.count == 0) continue;
+        std::cout << "  " << std::left << std::setw(20) << latencyStageName(static_cast<LatencyStage>(stage))
+                  << std::right << " p50 " << s.p50Ns / 1000.0 << "  p99 " << s.p99Ns / 1000.0
+                  << "  p99.9 " << s.p999Ns / 1000.0 << "  max " << s.maxNs / 1000.0
+                  << "  (" << s.count << " samples)\n";
+    }
+    const UDPListenerStats& ingest = getUDPListenerStats();
+    std::cout << "Listeners:";
+    for (uint64_t i = 0; i < ingest.listeners.load(); ++i) {
+        std::cout << " " << ingest.perListener[i].load();
+    }
+    std::cout << " packets\n";
+    std::cout << "Receive: " << ingest.packetsPerSyscall() << " packets/syscall";
+    if (opt.ioUring) {
+        std::cout << " (" << ingest.uringListeners.load() << " of " << ingest.listeners.load()
+                  << " listeners on io_uring, " << ingest.bufferStalls.load() << " buffer stalls)";
+    }
+    std::cout << "\n";
+    const SequenceStats& seq = g_sequenceTracker.stats();
+    uint64_t lost = 0, duplicates = 0, outOfOrder = 0;
+    for (const SequenceTypeStats& type : seq.types) {
+        lost += type.gaps.load();
+        duplicates += type.duplicates.load();
+        outOfOrder += type.outOfOrder.load();
+    }
+    std::cout << "Sequence tracker: ~" << lost << " frames lost, " << duplicates << " duplicate, "
+              << outOfOrder << " out of order, " << seq.flashbacks.load() << " flashbacks\n";
+    for (const RelayTargetStats& relay : g_relay.stats()) {
+        std::cout << "Relay " << relay.spec << ": " << relay.forwarded << " forwarded, " << relay.decimated
+                  << " rate limited, " << relay.dropped << " dropped (backed up), " << relay.errors << " errors\n";
+    }
+    std::cout << "Sessions: " << g_sessions.stats().created.load() << " created, "
+              << g_sessions.stats().evicted.load() << " evicted, "
+              << g_sessions.stats().builtInline.load() << " built on the ingest thread\n";
+    for (const std::shared_ptr<LiveSession>& session : g_sessions.sessions()) {
+        const FrameAssemblerStats& frames = session->frames.stats();
+        std::cout << "  " << describeSession(session->key()) << ": " << session->packets.load() << " packets, frames "
+                  << frames.complete.load() << " complete, "
+                  << frames.partial.load() << " partial (" << frames.evicted.load() << " evicted), "
+                  << frames.late.load() << " late packets\n";
+    }
+    if (!opt.latencyReport.empty() && writeLatencyReport(opt.latencyReport)) {
+        std::cout << "Latency report written to " << opt.latencyReport << "\n";
+    }
+
+    g_packetLog.stop();
+    const AsyncLogStats& logStats = g_packetLog.stats();
+    std::cout << "Packet log: " << logStats.written.load() << " written, " << logStats.dropped.load()
+              << " dropped (queue high water " << logStats.highWater.load() << ")";
+    if (opt.ioUring) std::cout << ", " << logStats.ringSubmits.load() << " io_uring submits";
+    std::cout << "\n";
+    return 0;
+}
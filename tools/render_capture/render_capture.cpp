@@ -0,0 +1,73 @@
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <ctime>
+#include <sys/stat.h>
+#include "../../core/captureFile.hpp"
+#include "../../core/packetStructs.hpp"
+#include "../../core/packetWriters.hpp"
+#include "../../core/packetDispatch.hpp"
+
+// Render a binary session capture (.f1cap) into the per-type text logs the listener used to write live
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: render_capture <capture.f1cap> [output_dir]\n";
+        return 1;
+    }
+
+    std::string outDir = argc > 2 ? argv[2] : "telemetry_data";
+
+    CaptureReader reader;
+    if (!reader.open(argv[1])) {
+        return 1;
+    }
+
+    struct stat st;
+    if (stat(outDir.c_str(), &st) != 0) {
+        mkdir(outDir.c_str(), 0755);
+    }
+
+    std::cout << "Session " << std::hex << reader.header().sessionUID << std::dec << "\n";
+
+    std::map<uint8_t, std::unique_ptr<std::ofstream>> files;
+    CaptureRecord record;
+    uint64_t count = 0;
+    uint64_t rejected = 0;
+
+    while (reader.next(record)) {
+        if (!validatePacket(record.data, record.size)) {
+            ++rejected;
+            continue;
+        }
+        const PacketHeader* header = reinterpret_cast<const PacketHeader*>(record.data);
+        auto& file = files[header->m_packetId];
+        if (!file) {
+            std::string path = outDir + "/" + getPacketTypeName(header->m_packetId) + ".txt";
+            file.reset(new std::ofstream(path, std::ios::trunc));
+            if (!file->is_open()) {
+                std::cerr << "Warning: Unable to open file: " << path << "\n";
+            }
+        }
+        if (!file->is_open()) continue;
+
+        char stamp[32];
+        time_t t = static_cast<time_t>(record.receivedNs / 1000000000ull);
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", std::localtime(&t));
+        *file << "==== " << stamp << " ====\n";
+
+        callPacketTypeWriter(record.data, *file, header->m_packetId);
+        ++count;
+    }
+
+    std::cout << "Rendered " << count << " packets to " << outDir << "/";
+    if (reader.resyncs() > 0) {
+        std::cout << " (" << reader.resyncs() << " corrupt regions skipped)";
+    }
+    if (rejected > 0) {
+        std::cout << " (" << rejected << " malformed packets skipped)";
+    }
+    std::cout << "\n";
+    return 0;
+}
@@ -0,0 +1,394 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "../../live/RingBuffer.hpp"
+#include "../../live/LiveTelemetry.hpp"
+
+// Stress test for the seqlock RingBuffer used by the live views.
+//
+//   ringbuffer_stress [--rate 10000] [--duration 5] [--readers 3]
+//
+// One writer pushes LiveInputSamples at --rate Hz (0 = as fast as possible) while the
+// readers hammer copy() and peekLatest(), plus one incremental readSince() reader, the
+// way the Visualizer and ReferenceTracker do. Every field of a sample is derived from
+// its sequence number, so a torn read, a stale slot or a gap in a snapshot is detected
+// exactly. Exits non-zero if any inconsistency was seen.
+//
+//   ringbuffer_stress --bench [--readers 3]
+//
+// Times RingBuffer against the previous implementation (PreviousRingBuffer below, which
+// indexed with % and / per slot and loaded each slot's sequence before writing it) at the
+// default full-rate capacity: ns per push alone and with readers polling peekLatest() /
+// readSince() on other threads, and ns per sample for full copy() / readSince() reads.
+// Cache misses on the writer thread stand in for cross-core traffic where perf counters
+// are available (Linux, perf_event_paranoid <= 2, not in most VMs).
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr size_t kCapacity = 512;
+
+LiveInputSample makeSample(uint64_t n) {
+    LiveInputSample s;
+    s.throttle = static_cast<float>(n % 1000) / 1000.0f;
+    s.brake = 1.0f - s.throttle;
+    s.steer = static_cast<float>(n % 200) / 100.0f - 1.0f;
+    s.timestampMs = n;
+    s.speed = static_cast<uint16_t>(n * 3);
+    s.engineRPM = static_cast<uint16_t>(n * 7);
+    s.clutch = static_cast<uint8_t>(n % 101);
+    s.gear = static_cast<int8_t>(n % 9) - 1;
+    s.drs = static_cast<uint8_t>(n & 1);
+    s.revLightsPercent = static_cast<uint8_t>(n % 100);
+    return s;
+}
+
+bool consistent(const LiveInputSample& s) {
+    LiveInputSample e = makeSample(s.timestampMs);
+    return s.throttle == e.throttle && s.brake == e.brake && s.steer == e.steer &&
+           s.speed == e.speed && s.engineRPM == e.engineRPM && s.clutch == e.clutch &&
+           s.gear == e.gear && s.drs == e.drs && s.revLightsPercent == e.revLightsPercent;
+}
+
+// ===================== BENCH =====================
+
+// RingBuffer as it was before division-free indexing, kept to benchmark against
+template<typename T>
+class PreviousRingBuffer {
+public:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    explicit PreviousRingBuffer(size_t capacity) : slotCount(capacity), owned(new Slot[capacity]) {}
+
+    void push(const T& value) {
+        size_t w = writeIndex.load(std::memory_order_relaxed);
+        Slot& slot = owned[w % slotCount];
+        uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+        slot.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(slot.data, &value, sizeof(T));
+        slot.seq.store(seq + 2, std::memory_order_release);
+        writeIndex.store(w + 1, std::memory_order_release);
+    }
+
+    size_t copy(T* out, size_t maxCount) const {
+        size_t w = writeIndex.load(std::memory_order_acquire);
+        size_t count = (w > maxCount) ? maxCount : w;
+        if (count > slotCount) count = slotCount;
+        size_t copied = 0;
+        for (size_t i = w - count; i < w; i++) {
+            if (readSlot(i, out[copied])) copied++;
+            else copied = 0;
+        }
+        return copied;
+    }
+
+    bool peekLatest(T& out) const {
+        for (;;) {
+            size_t w = writeIndex.load(std::memory_order_acquire);
+            if (w == 0) return false;
+            if (readSlot(w - 1, out)) return true;
+        }
+    }
+
+    size_t readSince(size_t& cursor, T* out, size_t maxCount, bool* overrun = nullptr) const {
+        size_t w = writeIndex.load(std::memory_order_acquire);
+        bool lost = false;
+        if (cursor > w) cursor = w;
+        if (w - cursor > slotCount) {
+            cursor = w - slotCount;
+            lost = true;
+        }
+        size_t end = (w - cursor > maxCount) ? cursor + maxCount : w;
+        size_t copied = 0;
+        for (size_t i = cursor; i < end; i++) {
+            if (readSlot(i, out[copied])) copied++;
+            else { copied = 0; lost = true; }
+        }
+        cursor = end;
+        if (overrun) *overrun = lost;
+        return copied;
+    }
+
+    size_t written() const { return writeIndex.load(std::memory_order_acquire); }
+
+private:
+    bool readSlot(size_t index, T& out) const {
+        const Slot& slot = owned[index % slotCount];
+        const uint64_t expected = 2 * (static_cast<uint64_t>(index / slotCount) + 1);
+        if (slot.seq.load(std::memory_order_acquire) != expected) return false;
+        std::memcpy(&out, slot.data, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.seq.load(std::memory_order_relaxed) == expected;
+    }
+
+    size_t slotCount;
+    std::unique_ptr<Slot[]> owned;
+    alignas(64) std::atomic<size_t> writeIndex{0};
+};
+
+// Hardware cache misses of the calling thread, or unavailable
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+
+    bool available() const { return fd_ >= 0; }
+
+    uint64_t read() const {
+        uint64_t count = 0;
+#ifdef __linux__
+        if (fd_ < 0 || ::read(fd_, &count, sizeof(count)) != sizeof(count)) return 0;
+#endif
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+double nsSince(Clock::time_point start, uint64_t ops) {
+    return ops ? std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ops : 0.0;
+}
+
+struct BenchResult {
+    double pushNs = 0;          // writer alone
+    double contendedPushNs = 0; // writer with readers polling
+    double peekNs = 0;          // readers' peekLatest(), while the writer pushes
+    double missesPerPush = -1;  // writer cache misses per contended push, -1 = no counter
+    double copyNs = 0;          // per sample, full-capacity copy()
+    double readSinceNs = 0;     // per sample, readSince() over the whole ring
+};
+
+template<typename Ring>
+BenchResult runBench(size_t capacity, int readers) {
+    BenchResult result;
+    Ring ring(capacity);
+    std::vector<LiveInputSample> out(capacity);
+    volatile uint64_t sink = 0;
+
+    const uint64_t pushes = 20 * capacity * 100;
+    auto start = Clock::now();
+    for (uint64_t n = 0; n < pushes; ++n) ring.push(makeSample(n));
+    result.pushNs = nsSince(start, pushes);
+
+    const int reads = 2000;
+    start = Clock::now();
+    for (int r = 0; r < reads; ++r) sink = sink + ring.copy(out.data(), capacity);
+    result.copyNs = nsSince(start, static_cast<uint64_t>(reads) * capacity);
+
+    start = Clock::now();
+    for (int r = 0; r < reads; ++r) {
+        size_t cursor = ring.written() - capacity;
+        sink = sink + ring.readSince(cursor, out.data(), capacity);
+    }
+    result.readSinceNs = nsSince(start, static_cast<uint64_t>(reads) * capacity);
+
+    // Readers poll the newest sample and read incrementally the way the render thread does,
+    // flat out, while the writer pushes
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> peeks{0};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&]() {
+            std::vector<LiveInputSample> batch(64);
+            size_t cursor = ring.written();
+            uint64_t local = 0;
+            LiveInputSample latest;
+            while (running.load(std::memory_order_relaxed)) {
+                if (ring.peekLatest(latest)) sink = sink + latest.timestampMs;
+                ring.readSince(cursor, batch.data(), batch.size());
+                ++local;
+            }
+            peeks.fetch_add(local);
+        });
+    }
+
+    CacheMissCounter misses;
+    uint64_t missesBefore = misses.read();
+    auto readStart = Clock::now();
+    start = Clock::now();
+    for (uint64_t n = 0; n < pushes; ++n) ring.push(makeSample(n));
+    result.contendedPushNs = nsSince(start, pushes);
+    if (misses.available()) result.missesPerPush = static_cast<double>(misses.read() - missesBefore) / pushes;
+    running.store(false);
+    for (auto& t : threads) t.join();
+    result.peekNs = peeks.load() ? std::chrono::duration<double, std::nano>(Clock::now() - readStart).count() *
+                                       readers / peeks.load()
+                                 : 0.0;
+    return result;
+}
+
+int runBenchmarks(int readers) {
+    const size_t capacity = LiveHistoryConfig{}.fullRateSamples();
+    std::cout << "Capacity " << capacity << " samples of " << sizeof(LiveInputSample) << " bytes, " << readers
+              << " polling readers, " << std::thread::hardware_concurrency() << " cores\n";
+
+    BenchResult previous = runBench<PreviousRingBuffer<LiveInputSample>>(capacity, readers);
+    BenchResult current = runBench<RingBuffer<LiveInputSample>>(capacity, readers);
+
+    auto row = [](const char* name, double before, double after, const char* unit) {
+        std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << before << std::setw(10) << after << "  " << unit << "\n";
+    };
+    std::cout << "  " << std::left << std::setw(28) << "" << std::right << std::setw(10) << "previous"
+              << std::setw(10) << "current" << "\n";
+    row("push", previous.pushNs, current.pushNs, "ns/op");
+    row("push, readers polling", previous.contendedPushNs, current.contendedPushNs, "ns/op");
+    row("peekLatest + readSince", previous.peekNs, current.peekNs, "ns/op (reader loop)");
+    row("copy (full ring)", previous.copyNs, current.copyNs, "ns/sample");
+    row("readSince (full ring)", previous.readSinceNs, current.readSinceNs, "ns/sample");
+    if (current.missesPerPush >= 0) {
+        row("writer cache misses", previous.missesPerPush, current.missesPerPush, "per push (readers polling)");
+    } else {
+        std::cout << "  writer cache misses: no hardware perf counters here\n";
+    }
+    return 0;
+}
+
+struct ReaderResult {
+    uint64_t snapshots = 0;
+    uint64_t samples = 0;
+    uint64_t torn = 0;        // sample whose fields disagree with its own sequence number
+    uint64_t gaps = 0;        // snapshot not strictly consecutive
+    uint64_t backwards = 0;   // peekLatest() went back in time
+    uint64_t overruns = 0;    // readSince() reported lost values (not a failure)
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    double rate = 10000.0;
+    double duration = 5.0;
+    int readers = 3;
+    bool bench = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--rate" && i + 1 < argc) rate = std::atof(argv[++i]);
+        else if (arg == "--duration" && i + 1 < argc) duration = std::atof(argv[++i]);
+        else if (arg == "--readers" && i + 1 < argc) readers = std::atoi(argv[++i]);
+        else if (arg == "--bench") bench = true;
+        else {
+            std::cerr << "Usage: ringbuffer_stress [--rate HZ] [--duration S] [--readers N] | --bench [--readers N]\n";
+            return 1;
+        }
+    }
+
+    if (bench) return runBenchmarks(readers);
+
+    static RingBuffer<LiveInputSample> ring(kCapacity);
+    std::atomic<bool> running{true};
+    std::vector<ReaderResult> results(readers);
+    std::vector<std::thread> threads;
+
+    // Cursor reader: successive readSince() batches must join up unless an overrun is reported
+    ReaderResult cursorResult;
+    threads.emplace_back([&]() {
+        ReaderResult& res = cursorResult;
+        std::vector<LiveInputSample> batch(kCapacity);
+        size_t cursor = 0;
+        uint64_t expected = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            bool overrun = false;
+            size_t n = ring.readSince(cursor, batch.data(), 64, &overrun);
+            if (n == 0) continue;
+            ++res.snapshots;
+            res.samples += n;
+            if (overrun) ++res.overruns;
+            else if (batch[0].timestampMs != expected) ++res.gaps;
+            for (size_t i = 0; i < n; ++i) {
+                if (!consistent(batch[i])) ++res.torn;
+                if (i > 0 && batch[i].timestampMs != batch[i - 1].timestampMs + 1) ++res.gaps;
+            }
+            expected = batch[n - 1].timestampMs + 1;
+        }
+    });
+
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            ReaderResult& res = results[r];
+            std::vector<LiveInputSample> snapshot(kCapacity);
+            uint64_t lastLatest = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                size_t n = ring.copy(snapshot.data(), kCapacity);
+                ++res.snapshots;
+                res.samples += n;
+                for (size_t i = 0; i < n; ++i) {
+                    if (!consistent(snapshot[i])) ++res.torn;
+                    if (i > 0 && snapshot[i].timestampMs != snapshot[i - 1].timestampMs + 1) ++res.gaps;
+                }
+
+                LiveInputSample latest;
+                if (ring.peekLatest(latest)) {
+                    if (!consistent(latest)) ++res.torn;
+                    if (latest.timestampMs < lastLatest) ++res.backwards;
+                    lastLatest = latest.timestampMs;
+                }
+            }
+        });
+    }
+
+    // Writer: paced like the listener, or flat out with --rate 0
+    uint64_t pushed = 0;
+    auto start = Clock::now();
+    auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(duration));
+    const auto period = rate > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate))
+                                 : Clock::duration::zero();
+    for (auto now = start; now < end; now = Clock::now()) {
+        if (rate > 0) {
+            auto due = start + period * static_cast<Clock::rep>(pushed);
+            while (Clock::now() < due) std::this_thread::yield();
+        }
+        ring.push(makeSample(pushed++));
+    }
+    running.store(false);
+    for (auto& t : threads) t.join();
+
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "Writer: " << pushed << " samples in " << elapsed << " s (" << pushed / elapsed << " Hz)\n";
+
+    uint64_t failures = 0;
+    for (int r = 0; r < readers; ++r) {
+        const ReaderResult& res = results[r];
+        std::cout << "Reader " << r << ": " << res.snapshots << " snapshots, " << res.samples << " samples, "
+                  << res.torn << " torn, " << res.gaps << " gaps, " << res.backwards << " backwards\n";
+        failures += res.torn + res.gaps + res.backwards;
+    }
+
+    std::cout << "Cursor reader: " << cursorResult.snapshots << " reads, " << cursorResult.samples << " samples, "
+              << cursorResult.torn << " torn, " << cursorResult.gaps << " gaps, " << cursorResult.overruns
+              << " overruns\n";
+    failures += cursorResult.torn + cursorResult.gaps;
+
+    std::cout << (failures ? "FAIL" : "PASS") << "\n";
+    return failures ? 1 : 0;
+}